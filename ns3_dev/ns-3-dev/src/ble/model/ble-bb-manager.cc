@@ -54,7 +54,20 @@ namespace ns3 {
       return tid;
     }
 
+  /*
+   * Key of an address in the link index
+   */
+  static uint16_t
+  GetLinkIndexKey (Mac16Address address)
+  {
+    uint8_t buffer[2];
+    address.CopyTo (buffer);
+    return (buffer[0] << 8) | buffer[1];
+  }
+
   BleBBManager::BleBBManager ()
+    : m_linkIndexValid (false),
+      m_startingTransmitWindows (false)
   {
     NS_LOG_FUNCTION (this);
   }
@@ -68,9 +81,13 @@ namespace ns3 {
     BleBBManager::DoDispose ()
     {
       NS_LOG_FUNCTION (this);
+      m_anchorEvent.Cancel ();
+      m_anchorPoints.clear ();
     }
 
   BleBBManager::BleBBManager (Ptr<BleNetDevice> bleNetDevice)
+    : m_linkIndexValid (false),
+      m_startingTransmitWindows (false)
   {
     NS_LOG_FUNCTION (this);
 
@@ -95,13 +112,6 @@ namespace ns3 {
       return this->GetNetDevice()->GetPhy();
     }
 
-  Ptr<DropTailQueue<QueueItem>>
-    BleBBManager::GetQueue (void)
-    {
-      NS_LOG_FUNCTION (this);
-      return this->GetNetDevice()->GetQueue();
-    }
-
   Ptr<BleLinkController>
     BleBBManager::GetLinkController()
     {
@@ -157,6 +167,7 @@ namespace ns3 {
       if (! LinkManagerExists(linkManager))
       {
         m_linkManagers.push_back(linkManager);
+        InvalidateLinkIndex ();
       }
       else
       {
@@ -353,30 +364,7 @@ namespace ns3 {
     BleBBManager::LinkExists (Mac16Address address)
     {
       NS_LOG_FUNCTION (this);
-      std::list<Ptr<BleLinkManager>>::iterator it;
-      for (it = m_linkManagers.begin(); it != m_linkManagers.end(); ++it)
-      {
-        std::list<Ptr<BleBBManager>>::iterator it2;
-        Ptr<BleLinkManager> lm = *it;
-        Ptr<BleLink> temp = lm->GetAssociatedLink();
-        if (temp->GetLinkType() == BleLink::LinkType::BROADCAST 
-            && address == Mac16Address("FF:FF"))
-          return true;
-        std::list<Ptr<BleBBManager>> all_devices = temp->GetLinkedDevices();
-        for (it2 = all_devices.begin(); it2 != all_devices.end(); ++it2)
-        {
-          Ptr<BleBBManager> bbm = *it2;
-          NS_ASSERT(bbm != 0);
-          Ptr<BleNetDevice> nd = bbm->GetNetDevice ();
-          NS_ASSERT(nd != 0);
-          if (nd->GetAddress16() == address 
-              && temp->GetLinkType() != BleLink::LinkType::BROADCAST) 
-          {
-            return true;
-          }
-        }
-      }
-      return false;
+      return FindLinkManager (address) != 0;
     }
   
   
@@ -384,31 +372,13 @@ namespace ns3 {
     BleBBManager::GetLinkManager (Mac16Address address)
     {
       NS_LOG_FUNCTION (this);
-      std::list<Ptr<BleLinkManager>>::iterator it;
-      for (it = m_linkManagers.begin(); it != m_linkManagers.end(); ++it)
+      Ptr<BleLinkManager> lm = FindLinkManager (address);
+      if (lm != 0)
       {
-        std::list<Ptr<BleBBManager>>::iterator it2;
-        Ptr<BleLinkManager> lm = *it;
-        Ptr<BleLink> temp = lm->GetAssociatedLink();
-        if (temp->GetLinkType() == BleLink::LinkType::BROADCAST 
-            && address == Mac16Address("FF:FF"))
-          return lm;
-        std::list<Ptr<BleBBManager>> all_devices = temp->GetLinkedDevices();
-        for (it2 = all_devices.begin(); it2 != all_devices.end(); ++it2)
-        {
-          Ptr<BleBBManager> bbm = *it2;
-          NS_ASSERT(bbm != 0);
-          Ptr<BleNetDevice> nd = bbm->GetNetDevice ();
-          NS_ASSERT(nd != 0);
-          if (nd->GetAddress16() == address 
-              && temp->GetLinkType() != BleLink::LinkType::BROADCAST) 
-          {
-            return lm;
-          }
-        }
+        return lm;
       }
       NS_LOG_WARN ("There is no link to a device with address " << address);
-      Ptr<BleLinkManager> lm = CreateObject<BleLinkManager> ();
+      lm = CreateObject<BleLinkManager> ();
       return lm;
     }
   
@@ -417,32 +387,71 @@ namespace ns3 {
     BleBBManager::GetLink (Mac16Address address)
     {
       NS_LOG_FUNCTION (this);
-      std::list<Ptr<BleLinkManager>>::iterator it;
-      for (it = m_linkManagers.begin(); it != m_linkManagers.end(); ++it)
+      Ptr<BleLinkManager> lm = FindLinkManager (address);
+      if (lm != 0)
+      {
+        return lm->GetAssociatedLink();
+      }
+      NS_LOG_WARN ("There is no link to a device with address " << address);
+      Ptr<BleLink> link = CreateObject<BleLink> ();
+      return link;
+    }
+
+  void
+    BleBBManager::InvalidateLinkIndex ()
+    {
+      m_linkIndexValid = false;
+    }
+
+  void
+    BleBBManager::BuildLinkIndex ()
+    {
+      NS_LOG_FUNCTION (this);
+      m_linkIndex.clear();
+      m_broadcastLinkManager = 0;
+      for (auto lm : m_linkManagers)
       {
-        std::list<Ptr<BleBBManager>>::iterator it2;
-        Ptr<BleLinkManager> lm = *it;
         Ptr<BleLink> temp = lm->GetAssociatedLink();
-        if (temp->GetLinkType() == BleLink::LinkType::BROADCAST 
-            && address == Mac16Address("FF:FF"))
-          return temp;
-        std::list<Ptr<BleBBManager>> all_devices = temp->GetLinkedDevices();
-        for (it2 = all_devices.begin(); it2 != all_devices.end(); ++it2)
+        if (temp->GetLinkType() == BleLink::LinkType::BROADCAST)
+        {
+          // Broadcast links only carry the broadcast address
+          if (m_broadcastLinkManager == 0)
+          {
+            m_broadcastLinkManager = lm;
+          }
+          continue;
+        }
+        for (const Ptr<BleBBManager> &bbm : temp->GetLinkedDevices())
         {
-          Ptr<BleBBManager> bbm = *it2;
           NS_ASSERT(bbm != 0);
           Ptr<BleNetDevice> nd = bbm->GetNetDevice ();
           NS_ASSERT(nd != 0);
-          if (nd->GetAddress16() == address 
-              && temp->GetLinkType() != BleLink::LinkType::BROADCAST) 
-          {
-            return temp;
-          }
+          // The first link manager in the list wins
+          m_linkIndex.insert (std::make_pair (
+                GetLinkIndexKey (nd->GetAddress16()), lm));
         }
       }
-      NS_LOG_WARN ("There is no link to a device with address " << address);
-      Ptr<BleLink> link = CreateObject<BleLink> ();
-      return link;
+      m_linkIndexValid = true;
+    }
+
+  Ptr<BleLinkManager>
+    BleBBManager::FindLinkManager (Mac16Address address)
+    {
+      if (!m_linkIndexValid)
+      {
+        BuildLinkIndex ();
+      }
+      if (address.IsBroadcast ())
+      {
+        return m_broadcastLinkManager;
+      }
+      std::unordered_map<uint16_t, Ptr<BleLinkManager>>::const_iterator it =
+        m_linkIndex.find (GetLinkIndexKey (address));
+      if (it == m_linkIndex.end ())
+      {
+        return 0;
+      }
+      return it->second;
     }
   
   
@@ -452,44 +461,79 @@ namespace ns3 {
       return m_linkManagers.size();
     }
 
-   void
-    BleBBManager::TryAgain()
+  void
+    BleBBManager::ScheduleTransmitWindow (Ptr<BleLinkManager> lm, Time delay)
+    {
+      NS_LOG_FUNCTION (this << lm << delay);
+      Time anchor = Simulator::Now () + delay;
+      // Equal anchor points keep the order in which they were scheduled
+      m_anchorPoints.insert (std::make_pair (anchor, lm));
+
+      // While starting windows, the event is scheduled afterwards
+      if (m_startingTransmitWindows)
+      {
+        return;
+      }
+      if (m_anchorEvent.IsRunning () 
+          && m_anchorEvent.GetTs () <= static_cast<uint64_t> (anchor.GetTimeStep ()))
+      {
+        return;
+      }
+      m_anchorEvent.Cancel ();
+      m_anchorEvent = Simulator::Schedule (delay, 
+          &BleBBManager::StartTransmitWindows, this);
+    }
+
+  void
+    BleBBManager::StartTransmitWindows ()
+    {
+      NS_LOG_FUNCTION (this);
+      Time now = Simulator::Now ();
+      m_startingTransmitWindows = true;
+      while (! m_anchorPoints.empty () && m_anchorPoints.begin ()->first <= now)
+      {
+        // The first window takes the radio, the others at the same
+        // time find it busy and are skipped
+        Ptr<BleLinkManager> lm = m_anchorPoints.begin ()->second;
+        m_anchorPoints.erase (m_anchorPoints.begin ());
+        lm->StartTransmitWindow ();
+      }
+      m_startingTransmitWindows = false;
+
+      if (! m_anchorPoints.empty ())
+      {
+        m_anchorEvent = Simulator::Schedule (
+            m_anchorPoints.begin ()->first - now,
+            &BleBBManager::StartTransmitWindows, this);
+      }
+    }
+
+  uint32_t
+    BleBBManager::GetSkippedTransmitWindows ()
     {
-      HandlePacket();
+      uint32_t skipped = 0;
+      for (auto lm : m_linkManagers)
+      {
+        skipped += lm->GetSkippedTransmitWindows ();
+      }
+      return skipped;
     }
 
-   void
-     BleBBManager::HandlePacket()
+   bool
+     BleBBManager::EnqueuePacket (Ptr<Packet> packet, Mac16Address destAddr)
      {
-       NS_LOG_FUNCTION (this);
-       while (this->GetNetDevice()->GetQueue()->IsEmpty () == false)
+       NS_LOG_FUNCTION (this << destAddr);
+       NS_LOG_INFO ("Destination addr of current packet: " << destAddr); 
+       Ptr<BleLinkManager> linkManager = FindLinkManager (destAddr);
+       if (linkManager == 0)
        {
-         NS_LOG_INFO ("Queue is not empty");
-         Ptr<QueueItem> item = this->GetNetDevice()->GetQueue()->Dequeue ();
-         NS_ASSERT (item);
-         Ptr<Packet> packet = item->GetPacket ();
-        
-         // Check dest address in header and get a link to the address
-         BleMacHeader macheader;
-         packet->PeekHeader(macheader);
-         Mac16Address destAddr = macheader.GetDestAddr();
-         NS_LOG_INFO ("Destination addr of current packet: " << destAddr); 
-         bool linkExists = LinkExists (destAddr);
-         if (!linkExists)
-         {
-           NS_LOG_ERROR (" No link exists to destination address " << destAddr);
-          // (if time allows: implement:) setup a link to the destination address
-          NS_ASSERT(linkExists);
-         }
-         else
-         {
-           NS_LOG_INFO (" Link to destination of current packet exists ");
-           Ptr<BleLinkManager> activeLinkManager = GetLinkManager (destAddr);
-           activeLinkManager->GetQueue ()->Enqueue (item);
-           
-         }
-       } // Queue was not empty
-       NS_LOG_INFO( "Queue is empty");
+         NS_LOG_ERROR (" No link exists to destination address " << destAddr);
+         // (if time allows: implement:) setup a link to the destination address
+         NS_ASSERT(linkManager != 0);
+         return false;
+       }
+       NS_LOG_INFO (" Link to destination of current packet exists ");
+       return linkManager->Enqueue (Create<QueueItem> (packet));
      }
 
  }
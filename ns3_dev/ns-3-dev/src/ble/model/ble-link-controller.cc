@@ -210,7 +210,8 @@ namespace ns3 {
       NS_LOG_FUNCTION(this);
       NS_ASSERT (this->GetCurrentPacket() != 0);
 
-      if (StartTransmission (this->GetCurrentPacket()->Copy(), false))
+      // No copy, as in StartPacketTransmission
+      if (StartTransmission (this->GetCurrentPacket(), false))
       {
         retransmissionCount++;
         m_macTxTrace (this->GetCurrentPacket());
@@ -264,7 +265,10 @@ namespace ns3 {
       NS_LOG_FUNCTION(this);
       NS_ASSERT (lm->GetCurrentPacket() != 0);
       
-      if (StartTransmission (lm->GetCurrentPacket()->Copy(), false)) 
+      // No copy: the packet is only read until the end of the
+      // transmission and the channel copies it for every receiver.
+      // Empty PDUs are shared, see BleLinkManager::GetEmptyPdu
+      if (StartTransmission (lm->GetCurrentPacket(), false)) 
       {
         m_macTxTrace (lm->GetCurrentPacket());
       }
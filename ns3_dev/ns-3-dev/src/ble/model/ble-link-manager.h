@@ -149,6 +149,23 @@ namespace ns3 {
        */
       Ptr<DropTailQueue<QueueItem>> GetQueue (void);
 
+      /**
+       * \brief Queue a packet for transmission over the link
+       *
+       * Resumes the transmit windows of the link if they were suspended
+       * because the connection was idle.
+       *
+       * \param item the packet
+       * \returns false if the queue is full
+       */
+      bool Enqueue (Ptr<QueueItem> item);
+
+      /**
+       * \returns true if the transmit windows are suspended because the
+       * connection is idle (see the LazyTransmitWindows attribute)
+       */
+      bool IsSuspended (void) const;
+
       void SetCurrentPacket (Ptr<Packet> packet);
       Ptr<Packet> GetCurrentPacket (void);
 
@@ -156,6 +173,12 @@ namespace ns3 {
       void EndTransmitWindow (void);
       void PrepareNextTransmitWindow (void);
 
+      /*
+       * Returns the number of transmit windows of this link manager that
+       * were skipped because the radio was busy with another link
+       */
+      uint32_t GetSkippedTransmitWindows (void);
+
       void HandleTXDone (void);
       void SendNextPacket (void);
 
@@ -205,14 +228,46 @@ namespace ns3 {
 
     private:
 
+      /*
+       * Returns true if nothing is waiting to be sent on this side of
+       * the link
+       */
+      bool IsIdle (void);
+
+      /*
+       * Returns true if the windows of the link can be suspended at
+       * this anchor point
+       */
+      bool CanSuspend (void);
+
+      /*
+       * Stops scheduling transmit windows, the current anchor point
+       * is the first one that is skipped
+       */
+      void Suspend (void);
+
+      /*
+       * Schedules the first anchor point that is not in the past,
+       * accounting the connection events and channel hops of the
+       * skipped ones
+       */
+      void Resume (void);
+
+      /*
+       * Returns the empty PDU for the current sequence numbers. Empty
+       * PDUs of a link only differ in SN and NESN, the four variants
+       * are built once and shared by all keep-alive transmissions.
+       */
+      Ptr<Packet> GetEmptyPdu (void);
+
       // This is false as long as no transmit window has past
       // sinds last connection establishment. This value is
       // set to false by the SetLastTimeConnectionEstablished()
       // function, set to true by SetLastTransmitWindowTime ()
       bool m_firstTransmitWindowDone;
 
-      EventId m_nextWindow;
       EventId m_endOfCurrentWindow;
+      uint32_t m_skippedTransmitWindows;
 
       State currentState;
       Role expectedRole;
@@ -239,6 +294,7 @@ namespace ns3 {
       Ptr<BleBBManager> m_bbManager;
       Ptr<Packet> m_currentPacket;
       bool m_currentIsDummy __attribute__((unused));
+      Ptr<Packet> m_emptyPdus[4]; //!< indexed by SN * 2 + NESN
 
       bool m_nextExpectedSequenceNumber;
       bool m_sequenceNumber;
@@ -262,6 +318,14 @@ namespace ns3 {
       uint8_t m_hopIncrement;
       uint8_t m_dataChannelIndex;
       std::vector<uint8_t> m_usedChannels;
+
+      // Suspend the transmit windows of idle point-to-point connections
+      bool m_lazyTransmitWindows;
+      bool m_suspended;
+      Time m_suspendedAnchor; //!< first anchor point that was skipped
+      // Other end of the link, not owned: both link managers are held by
+      // their BleBBManager, a Ptr in each direction would form a cycle
+      BleLinkManager *m_peerLinkManager;
   };
 }
 #endif /* BLE_LINK_MANAGER_H */
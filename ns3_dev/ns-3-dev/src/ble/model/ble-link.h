@@ -32,6 +32,8 @@
 
 #include <ns3/spectrum-channel.h>
 
+#include <vector>
+
 //#include <ns3/ble-bb-manager.h>
 
 namespace ns3 {
@@ -72,7 +74,9 @@ namespace ns3 {
       void SetMaster(Ptr<BleBBManager> bleBBManager);
       Ptr<BleBBManager> GetMaster();
 
-      std::list<Ptr<BleBBManager>> GetLinkedDevices();
+      // The slaves, followed by the master if there is one. The reference
+      // stays valid until the members of the link change.
+      const std::vector<Ptr<BleBBManager>> & GetLinkedDevices() const;
 
       void SetChannel (Ptr<SpectrumChannel> c);
       Ptr<SpectrumChannel> GetChannel();
@@ -80,8 +84,13 @@ namespace ns3 {
       Ptr<BleBBManager> GetLinkedDevice (Mac16Address addr);
 
     private:
+      // Tell the baseband managers of the linked devices that the
+      // members or the type of this link changed
+      void NotifyLinkChanged ();
+
       LinkType currentLinkType;
-      std::list<Ptr<BleBBManager>> m_slaves; 
+      // The slaves, followed by the master if there is one
+      std::vector<Ptr<BleBBManager>> m_linkedDevices;
       Ptr<BleBBManager> m_master;
 
       Ptr<SpectrumChannel> m_channel;
@@ -46,11 +46,9 @@
 
 namespace ns3 {
 
-template <typename Item> class DropTailQueue;
 class BlePhy;
 class SpectrumChannel;
 class Channel;
-class QueueItem;
 class BleChannel;
 class SpectrumErrorModel;
 class BleBBManager;
@@ -77,14 +75,6 @@ public:
   virtual ~BleNetDevice ();
 
 
-  /**
-   * set the queue which is going to be used by this device
-   *
-   * \param queue the wanted queue structure
-   */
-  virtual void SetQueue (Ptr<DropTailQueue<QueueItem>> queue);
-
-
   /**
    * Notify the MAC that the PHY has finished a previously started transmission
    *
@@ -194,7 +184,6 @@ public:
   Mac16Address GetAddress16 (void) const;
 
  
-  Ptr<DropTailQueue<QueueItem>> GetQueue (void);
   Ptr<BleBBManager> GetBBManager();
   void SetBBManager(Ptr<BleBBManager> bbManager);
 
@@ -206,7 +195,6 @@ public:
 
 protected:
 
-  Ptr<DropTailQueue<QueueItem>> m_queue; //!< queue for packets to send
   Ptr<Node>    m_node; //!< node of this netdevice
   Mac16Address m_address; //!< address of this device
   Ipv4Address m_ip_address; //!< address of this device
@@ -24,6 +24,7 @@
 
 #include "ble-phy.h"
 #include "ble-spectrum-signal-parameters.h"
+#include "ble-spectrum-channel.h"
 #include <ns3/ble-net-device.h>
 #include <ns3/ble-bb-manager.h>
 #include <ns3/object.h>
@@ -39,12 +40,19 @@
 #include <ns3/event-id.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/double.h>
+#include <ns3/enum.h>
+#include <cmath>
+#include <algorithm>
 
 
 namespace ns3 {
 
 	NS_LOG_COMPONENT_DEFINE ("BlePhy");
 
+    // Above this expected number of bit errors the binomial is
+    // approximated by a normal distribution instead of inverted.
+    const double BINOMIAL_INVERSION_LIMIT = 30;
+
 	NS_OBJECT_ENSURE_REGISTERED (BlePhy);
 
 
@@ -54,6 +62,14 @@ namespace ns3 {
 			static TypeId tid = TypeId ("ns3::BlePhy")
 				.SetParent<Object> ()
 				.AddConstructor<BlePhy> ()
+				.AddAttribute ("BitErrorSampling",
+                    "How the number of bit errors per interval is drawn: "
+                    "one draw per bit (Exact) or one draw per interval "
+                    "(Analytic).",
+					EnumValue (BlePhy::ANALYTIC_SAMPLING),
+					MakeEnumAccessor (&BlePhy::m_bitErrorSampling),
+					MakeEnumChecker (BlePhy::ANALYTIC_SAMPLING, "Analytic",
+                                     BlePhy::EXACT_SAMPLING, "Exact"))
 				;
 			return tid;
 		}
@@ -78,12 +94,15 @@ namespace ns3 {
 		m_channelSelector=CreateObject<UniformRandomVariable> ();
 		m_random->SetAttribute ("Min",DoubleValue(0.0));
 		m_random->SetAttribute ("Max",DoubleValue(1.0));
+		m_normal=CreateObject<NormalRandomVariable> ();
+		m_bitErrorSampling = ANALYTIC_SAMPLING;
 		m_equivalentNoiseTemperature = 293;
 		m_power = 0.010; 
                 // BLE specifications: min output power: 0.01 mW, max 10 mW
 		m_errorModel =Create<BleErrorModel> (); 
 		InitTxPowerSpectralDensity (m_channelIndex,m_power); //0.001);
-		m_receivingPower = Create<SpectrumValue> (m_txPsd->GetSpectrumModel ());
+		m_receivingPower.assign (
+            m_txPsd->GetSpectrumModel ()->GetNumBands (), 0);
 	}
 
 	BlePhy::~BlePhy ()
@@ -92,6 +111,7 @@ namespace ns3 {
 		m_netDevice = 0;
 		m_mobility = 0;
 		m_channel = 0;
+		m_attachedChannels.clear ();
 		m_antenna = 0;
 		m_txPsd = 0;
 	}
@@ -134,7 +154,11 @@ namespace ns3 {
 		BlePhy::SetChannel (Ptr<SpectrumChannel> c)
 		{
 			NS_LOG_FUNCTION (this);
-			c->AddRx(this);
+			// AddRx is linear in the number of receivers of the channel
+			if (m_attachedChannels.insert (c).second)
+			{
+				c->AddRx(this);
+			}
 			m_channel = c;
 		}
 
@@ -204,7 +228,12 @@ namespace ns3 {
       {
         m_txPsd = 0;
         m_txPsd = Create <SpectrumValue> (model);
-        m_receivingPower = Create<SpectrumValue> (m_txPsd->GetSpectrumModel ());
+        m_receivingPower.assign (model->GetNumBands (), 0);
+        // channels must be notified of a new spectrum model
+        for (auto &channel : m_attachedChannels)
+        {
+          channel->AddRx (this);
+        }
       }
 
 	void
@@ -269,7 +298,7 @@ namespace ns3 {
                 NS_ASSERT(m_channel != 0);
 				m_channel->StartTx (txParams);
 				Simulator::Schedule(txParams->duration,
-                    &BlePhy::EndTx,this,packet->Copy());
+                    &BlePhy::EndTx,this,packet);
                 NS_LOG_INFO ("EndTx event scheduled in: " << txParams->duration);
 				return true;
 			}
@@ -305,10 +334,16 @@ namespace ns3 {
 				// add power to received power
 				Simulator::Schedule(params->duration,
                     &BlePhy::EndNoise,this,params->psd);
-				*m_receivingPower += *params->psd;
+				AccumulateRxPower (params->psd, 1);
 				//m_ReceptionStart();
 				if (sfParams != 0){
 					uint8_t channel = sfParams->GetChannel();
+					// psd is final once delivered, integrate it only once
+					if (sfParams->GetRxPower () < 0)
+					{
+						sfParams->SetRxPower (Integral (*sfParams->psd));
+					}
+					double rxPower = sfParams->GetRxPower ();
 					//Choose highest SNR if multiple
 					if (m_params.size()<1){
 						m_params.push_back(sfParams);
@@ -333,14 +368,13 @@ namespace ns3 {
 								//if there is a collision, 
                                 //  No problem if 6dB power difference, 
                                 //  but other is corrupted;
-								if (Integral(*it->psd)*ccrejection 
-                                    < Integral(*sfParams->psd)){
+								if (it->GetRxPower ()*ccrejection < rxPower){
 									it->SetBer(10);
 								}
 								else{
 									//if 6dB lower power, there is no detection
-									if (Integral(*it->psd) 
-                                        > ccrejection*Integral(*sfParams->psd)){
+									if (it->GetRxPower () 
+                                        > ccrejection*rxPower){
 										sfParams->SetBer(10);
 									}
 									else
@@ -370,7 +404,26 @@ namespace ns3 {
 		{
 			NS_LOG_FUNCTION(this);
 			UpdateBer();
-			*m_receivingPower -= *sv;
+			AccumulateRxPower (sv, -1);
+		}
+
+	void
+		BlePhy::AccumulateRxPower (Ptr<const SpectrumValue> psd, double sign)
+		{
+			NS_ASSERT (psd->GetSpectrumModel ()->GetNumBands () 
+                == m_receivingPower.size ());
+			uint32_t band = 0;
+			for (Values::const_iterator it = psd->ConstValuesBegin ();
+                it != psd->ConstValuesEnd (); ++it, ++band)
+			{
+				m_receivingPower[band] += sign * (*it);
+			}
+		}
+
+	double
+		BlePhy::GetRxPower (uint8_t channelIndex) const
+		{
+			return m_receivingPower.at (channelIndex + 3);
 		}
 
 	void 
@@ -459,7 +512,27 @@ namespace ns3 {
    void
      BlePhy::SetChannelIndex (uint8_t channelIndex)
      {
+        if (channelIndex == m_channelIndex)
+        {
+          return;
+        }
         m_channelIndex = channelIndex;
+        // BLE channels keep their receivers per channel index
+        for (auto &channel : m_attachedChannels)
+        {
+          Ptr<BleSpectrumChannel> bleChannel = 
+            DynamicCast<BleSpectrumChannel> (channel);
+          if (bleChannel != 0)
+          {
+            bleChannel->ChannelIndexChanged (this);
+          }
+        }
+     }
+
+   uint8_t
+     BlePhy::GetChannelIndex (void) const
+     {
+        return m_channelIndex;
      }
 
    bool
@@ -527,32 +600,72 @@ namespace ns3 {
               uint8_t paramsChannelIndex = i->GetChannel();
               if (m_channelIndex == paramsChannelIndex )
               {
-				int m_bitErrors = 0;
 				//calculate SNR
-				Ptr<SpectrumValue> noise = m_receivingPower->Copy();
-				*noise -= *i->psd;
 				uint32_t channel = i->GetChannel();
-				double snr = 
-                  (*i->psd)[channel+3]/((*noise)[channel+3]+m_k*m_temperature);
+				double signal = (*i->psd)[channel+3];
+				double noise = m_receivingPower[channel+3] - signal;
+				double snr = signal/(std::max (noise, 0.0)+m_k*m_temperature);
 				//getBER
 				long double berEs = m_errorModel->GetBER (snr);
-				int bits = (timeNow - m_lastCheck)*m_bitrate / 4; 
+				int64_t bits = (timeNow - m_lastCheck)*m_bitrate / 4; 
                 // Divided by 4 to compensate for higher bitrate 
                 //  (see other remark at bitrate instantiation)
-				for ( int it = 0; it < bits; it++)
-				{
-					if(m_random->GetValue()<berEs)
-					{
-						//calculate numbers of biterrors	
-						m_bitErrors += 1;
-					}
-				}
-				i->SetBer(m_bitErrors+i->GetBer());
+				uint32_t bitErrors = DrawBitErrors (bits, berEs);
+				i->SetBer(bitErrors+i->GetBer());
               }
 			}
 			m_lastCheck = timeNow;
 		}
 
+  uint32_t
+    BlePhy::DrawBitErrors (int64_t bits, long double ber)
+    {
+      if (bits <= 0 || ber <= 0)
+        {
+          return 0;
+        }
+      if (m_bitErrorSampling == EXACT_SAMPLING)
+        {
+          uint32_t bitErrors = 0;
+          for (int64_t it = 0; it < bits; it++)
+            {
+              if (m_random->GetValue () < ber)
+                {
+                  bitErrors += 1;
+                }
+            }
+          return bitErrors;
+        }
+
+      double p = (double) ber;
+      if (p >= 1)
+        {
+          return bits;
+        }
+      double mean = bits * p;
+      if (mean > BINOMIAL_INVERSION_LIMIT)
+        {
+          double stddev = std::sqrt (mean * (1 - p));
+          double errors = 
+            std::floor (mean + stddev * m_normal->GetValue () + 0.5);
+          return (uint32_t) std::min (std::max (errors, 0.0), (double) bits);
+        }
+      // Walk the binomial CDF until it passes a single uniform draw,
+      // which costs on average one step per expected bit error.
+      double u = m_random->GetValue ();
+      double pmf = std::exp (bits * std::log1p (-p));
+      double cdf = pmf;
+      double odds = p / (1 - p);
+      int64_t k = 0;
+      while (u > cdf && k < bits)
+        {
+          pmf *= odds * (bits - k) / (k + 1);
+          k++;
+          cdf += pmf;
+        }
+      return k;
+    }
+
 		void
 			BlePhy::SetReceiverMode (bool receiver)
 			{
@@ -34,6 +34,8 @@
 #include "ble-spectrum-signal-parameters.h"
 #include <ns3/event-id.h>
 #include <ns3/random-variable-stream.h>
+#include <vector>
+#include <set>
 namespace ns3 {
 
 const int NB_BANDS = 40;
@@ -78,6 +80,15 @@ public:
     RX_BUSY 
   };
 
+  /**
+   * How the number of bit errors in an interval is drawn
+   */
+  enum BitErrorSampling
+  {
+    EXACT_SAMPLING,   // one uniform draw per elapsed bit
+    ANALYTIC_SAMPLING // one binomial draw per elapsed interval
+  };
+
   static TypeId GetTypeId (void);
 
   /**
@@ -110,7 +121,9 @@ public:
   Ptr<MobilityModel> GetMobility () const;
 
   /**
-   * Set the channel attached to this device.
+   * Set the channel attached to this device. The PHY is only registered
+   * as a receiver the first time it is attached to a channel, so hopping
+   * back to a channel does not touch the receivers of the channel.
    *
    * @param c the channel
    */
@@ -157,6 +170,16 @@ public:
    */
   void EndRx (Ptr<BleSpectrumSignalParameters> params);
   void EndNoise (Ptr<SpectrumValue> sv);
+
+  /**
+   * Get the total power of all signals currently being received
+   * in the band of a channel.
+   *
+   * @param channelIndex the channel
+   *
+   * @return the received power at the centre band of the channel
+   */
+  double GetRxPower (uint8_t channelIndex) const;
   /**
    *
    */
@@ -188,6 +211,7 @@ public:
   void SetReceiverMode (bool receiver);
 
   void SetChannelIndex(uint8_t channelIndex);
+  uint8_t GetChannelIndex (void) const;
   void SetPower (double power);
   void SetBandwidth (uint32_t bandwidth);
 
@@ -203,10 +227,28 @@ public:
 
   bool SetIdle (); // Return to the IDLE state and turn transceiver off
 
+  /**
+   * Draw the number of bit errors that occur in a number of bits
+   * with a given bit error rate.
+   *
+   * In EXACT_SAMPLING mode every bit is checked against a uniform draw.
+   * In ANALYTIC_SAMPLING mode the count is drawn from the equivalent
+   * binomial distribution: by CDF inversion when few errors are
+   * expected, by a normal approximation otherwise.
+   *
+   * @param bits number of bits in the interval
+   * @param ber bit error rate of every bit in the interval
+   *
+   * @return the number of bit errors
+   */
+  uint32_t DrawBitErrors (int64_t bits, long double ber);
+
 private:
  Ptr<NetDevice> m_netDevice; //upper layer
  Ptr<MobilityModel> m_mobility; //position
  Ptr<SpectrumChannel> m_channel; //channel to transmit on
+ std::set<Ptr<SpectrumChannel> > m_attachedChannels; //channels this PHY 
+                                                     //receives on
  Ptr<SpectrumValue> m_txPsd; //Current transmit psd
  Ptr<AntennaModel> m_antenna; //antenna to be used
  bool m_receiver; // whether or not this physical layer 
@@ -224,11 +266,14 @@ private:
  EventId m_events[40]; //current receiving events for sending
  double m_lastCheck; //last time check
  double m_equivalentNoiseTemperature; //noise temperature
- Ptr<SpectrumValue> m_receivingPower; //all the power at the receiving antenna
+ std::vector<double> m_receivingPower; //all the power at the receiving 
+                                       //antenna, per band
  Ptr<BleErrorModel> m_errorModel; // error model for this device
  Ptr<UniformRandomVariable> m_random; //determines whether received package 
                                       //is lost are not
  Ptr<UniformRandomVariable> m_channelSelector; //selects the channel
+ Ptr<NormalRandomVariable> m_normal; //binomial approximation for many errors
+ BitErrorSampling m_bitErrorSampling; //how bit errors are drawn
  //callbackfunctions
  Callback<void, Ptr<const Packet> > m_transmissionEnd; 
  Callback<void> m_ReceptionStart;
@@ -249,6 +294,15 @@ private:
   */
   void CreateTxPowerSpectralDensity (uint32_t channeloffset, double power);
 
+  /**
+   * Add the bands of a signal to (or remove them from) the power
+   * at the receiving antenna.
+   *
+   * @param psd the power spectral density of the signal
+   * @param sign 1 to add the signal, -1 to remove it
+   */
+  void AccumulateRxPower (Ptr<const SpectrumValue> psd, double sign);
+
   /**
    * Update the BER for all receiving transmissions based on latest information 
    */
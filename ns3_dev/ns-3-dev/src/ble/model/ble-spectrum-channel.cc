@@ -0,0 +1,343 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 KU Leuven
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "ble-spectrum-channel.h"
+#include "ble-phy.h"
+#include "ble-spectrum-signal-parameters.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/node.h>
+#include <ns3/net-device.h>
+#include <ns3/mobility-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BleSpectrumChannel");
+NS_OBJECT_ENSURE_REGISTERED (BleSpectrumChannel);
+
+TypeId
+BleSpectrumChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BleSpectrumChannel")
+    .SetParent<SpectrumChannel> ()
+    .AddConstructor<BleSpectrumChannel> ()
+    .AddAttribute ("AdjacentChannels",
+                   "Signals are delivered to the BlePhys tuned at most this "
+                   "many channel indices away from the transmitted index. "
+                   "The BLE power spectral density spans 3 indices on both "
+                   "sides.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&BleSpectrumChannel::m_adjacentChannels),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CacheLinkBudgets",
+                   "Reuse the link budget of a pair of static PHYs until one "
+                   "of them notifies a course change. Disable this with "
+                   "random propagation loss models.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&BleSpectrumChannel::m_cacheLinkBudgets),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LinkBudgetCacheSize",
+                   "Maximum number of cached link budgets. The cache is "
+                   "emptied when it is full.",
+                   UintegerValue (1000000),
+                   MakeUintegerAccessor (&BleSpectrumChannel::m_linkBudgetCacheSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+BleSpectrumChannel::BleSpectrumChannel (void)
+  : m_adjacentChannels (3),
+    m_cacheLinkBudgets (true),
+    m_linkBudgetCacheSize (1000000)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BleSpectrumChannel::~BleSpectrumChannel (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BleSpectrumChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_tracker.Clear ();
+  m_linkBudgets.clear ();
+  m_receivers.clear ();
+  m_receiverIndices.clear ();
+  m_buckets.clear ();
+  m_otherReceivers.clear ();
+  SpectrumChannel::DoDispose ();
+}
+
+std::size_t
+BleSpectrumChannel::PhyPairHash::operator() (const std::pair<const SpectrumPhy *,
+    const SpectrumPhy *> &pair) const
+{
+  std::size_t h = std::hash<const SpectrumPhy *> () (pair.first);
+  return h ^ (std::hash<const SpectrumPhy *> () (pair.second) + 0x9e3779b9
+      + (h << 6) + (h >> 2));
+}
+
+void
+BleSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  uint32_t index = m_receivers.size ();
+  if (!m_receiverIndices.insert (std::make_pair (PeekPointer (phy), index)).second)
+    {
+      return;
+    }
+  Receiver receiver;
+  receiver.m_phy = phy;
+  receiver.m_blePhy = DynamicCast<BlePhy> (phy);
+  receiver.m_channelIndex = 0;
+  receiver.m_bucketPosition = 0;
+  m_receivers.push_back (receiver);
+  if (receiver.m_blePhy != 0)
+    {
+      AddToBucket (index);
+    }
+  else
+    {
+      m_otherReceivers.push_back (index);
+    }
+}
+
+void
+BleSpectrumChannel::AddToBucket (uint32_t index)
+{
+  Receiver &receiver = m_receivers[index];
+  receiver.m_channelIndex = receiver.m_blePhy->GetChannelIndex ();
+  if (receiver.m_channelIndex >= m_buckets.size ())
+    {
+      m_buckets.resize (receiver.m_channelIndex + 1);
+    }
+  std::vector<uint32_t> &bucket = m_buckets[receiver.m_channelIndex];
+  receiver.m_bucketPosition = bucket.size ();
+  bucket.push_back (index);
+}
+
+void
+BleSpectrumChannel::ChannelIndexChanged (Ptr<const BlePhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  std::unordered_map<const SpectrumPhy *, uint32_t>::const_iterator it =
+    m_receiverIndices.find (PeekPointer (phy));
+  if (it == m_receiverIndices.end ()
+      || m_receivers[it->second].m_channelIndex == phy->GetChannelIndex ())
+    {
+      return;
+    }
+  // the last receiver of the old bucket takes the place of this one
+  Receiver &receiver = m_receivers[it->second];
+  std::vector<uint32_t> &bucket = m_buckets[receiver.m_channelIndex];
+  bucket[receiver.m_bucketPosition] = bucket.back ();
+  m_receivers[bucket.back ()].m_bucketPosition = receiver.m_bucketPosition;
+  bucket.pop_back ();
+  AddToBucket (it->second);
+}
+
+BleSpectrumChannel::LinkBudget
+BleSpectrumChannel::GetLinkBudget (Ptr<SpectrumSignalParameters> params,
+    Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> rxPhy,
+    Ptr<MobilityModel> rxMobility)
+{
+  uint64_t txEpoch = 0;
+  uint64_t rxEpoch = 0;
+  bool cacheable = m_cacheLinkBudgets
+    && m_tracker.GetEpoch (txMobility, txEpoch)
+    && m_tracker.GetEpoch (rxMobility, rxEpoch);
+  std::pair<const SpectrumPhy *, const SpectrumPhy *> key (
+      PeekPointer (params->txPhy), PeekPointer (rxPhy));
+  if (cacheable)
+    {
+      auto it = m_linkBudgets.find (key);
+      if (it != m_linkBudgets.end () && it->second.m_txEpoch == txEpoch
+          && it->second.m_rxEpoch == rxEpoch)
+        {
+          return it->second;
+        }
+    }
+
+  LinkBudget budget;
+  budget.m_txAntennaGainDb = 0;
+  budget.m_rxAntennaGainDb = 0;
+  budget.m_propagationGainDb = 0;
+  budget.m_pathLossDb = 0;
+  budget.m_delay = MicroSeconds (0);
+  budget.m_txEpoch = txEpoch;
+  budget.m_rxEpoch = rxEpoch;
+  if (params->txAntenna != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      budget.m_txAntennaGainDb = params->txAntenna->GetGainDb (txAngles);
+      budget.m_pathLossDb -= budget.m_txAntennaGainDb;
+    }
+  Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+      budget.m_rxAntennaGainDb = rxAntenna->GetGainDb (rxAngles);
+      budget.m_pathLossDb -= budget.m_rxAntennaGainDb;
+    }
+  if (m_propagationLoss)
+    {
+      budget.m_propagationGainDb =
+        m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+      budget.m_pathLossDb -= budget.m_propagationGainDb;
+    }
+  if (m_propagationDelay)
+    {
+      budget.m_delay = m_propagationDelay->GetDelay (txMobility, rxMobility);
+    }
+
+  if (cacheable)
+    {
+      if (m_linkBudgets.size () >= m_linkBudgetCacheSize)
+        {
+          m_linkBudgets.clear ();
+          m_tracker.Prune ();
+        }
+      m_linkBudgets[key] = budget;
+    }
+  return budget;
+}
+
+void
+BleSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams);
+  NS_ASSERT (txParams->txPhy);
+  NS_ASSERT (txParams->psd);
+  Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy ();
+  m_txSigParamsTrace (txParamsTrace);
+
+  Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  Ptr<BleSpectrumSignalParameters> bleParams =
+    DynamicCast<BleSpectrumSignalParameters> (txParams);
+
+  m_visited.clear ();
+  if (bleParams != 0)
+    {
+      // only the BlePhys on the channel indices reached by the power
+      m_visited.insert (m_visited.end (), m_otherReceivers.begin (),
+          m_otherReceivers.end ());
+      int64_t channelIndex = bleParams->GetChannel ();
+      int64_t first = std::max<int64_t> (0, channelIndex - m_adjacentChannels);
+      int64_t last = std::min<int64_t> (m_buckets.size () - 1,
+          channelIndex + m_adjacentChannels);
+      for (int64_t i = first; i <= last; i++)
+        {
+          m_visited.insert (m_visited.end (), m_buckets[i].begin (),
+              m_buckets[i].end ());
+        }
+      // in the order the receivers were added, as without buckets
+      std::sort (m_visited.begin (), m_visited.end ());
+    }
+  else
+    {
+      for (uint32_t i = 0; i < m_receivers.size (); i++)
+        {
+          m_visited.push_back (i);
+        }
+    }
+
+  for (uint32_t index : m_visited)
+    {
+      Receiver &receiver = m_receivers[index];
+      if (receiver.m_phy == txParams->txPhy)
+        {
+          continue;
+        }
+      NS_ASSERT (receiver.m_phy->GetRxSpectrumModel ()->GetNumBands ()
+          == txParams->psd->GetSpectrumModel ()->GetNumBands ());
+
+      Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+      rxParams->psd = Copy<SpectrumValue> (txParams->psd);
+      Time delay = MicroSeconds (0);
+
+      Ptr<MobilityModel> rxMobility = receiver.m_phy->GetMobility ();
+      if (txMobility && rxMobility)
+        {
+          LinkBudget budget = GetLinkBudget (txParams, txMobility,
+              receiver.m_phy, rxMobility);
+          m_gainTrace (txMobility, rxMobility, budget.m_txAntennaGainDb,
+              budget.m_rxAntennaGainDb, budget.m_propagationGainDb,
+              budget.m_pathLossDb);
+          m_pathLossTrace (txParams->txPhy, receiver.m_phy,
+              budget.m_pathLossDb);
+          if (budget.m_pathLossDb > m_maxLossDb)
+            {
+              // beyond range
+              continue;
+            }
+          *(rxParams->psd) *= std::pow (10.0, -budget.m_pathLossDb / 10.0);
+          if (m_spectrumPropagationLoss)
+            {
+              rxParams->psd = m_spectrumPropagationLoss
+                ->CalcRxPowerSpectralDensity (rxParams->psd, txMobility,
+                    rxMobility);
+            }
+          delay = budget.m_delay;
+        }
+
+      Ptr<NetDevice> netDev = receiver.m_phy->GetDevice ();
+      if (netDev && netDev->GetNode ())
+        {
+          Simulator::ScheduleWithContext (netDev->GetNode ()->GetId (), delay,
+              &BleSpectrumChannel::StartRx, this, rxParams, receiver.m_phy);
+        }
+      else
+        {
+          Simulator::Schedule (delay, &BleSpectrumChannel::StartRx, this,
+              rxParams, receiver.m_phy);
+        }
+    }
+}
+
+void
+BleSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params,
+    Ptr<SpectrumPhy> receiver)
+{
+  NS_LOG_FUNCTION (this);
+  receiver->StartRx (params);
+}
+
+std::size_t
+BleSpectrumChannel::GetNDevices (void) const
+{
+  return m_receivers.size ();
+}
+
+Ptr<NetDevice>
+BleSpectrumChannel::GetDevice (std::size_t i) const
+{
+  NS_ASSERT (i < m_receivers.size ());
+  return m_receivers[i].m_phy->GetDevice ();
+}
+
+} // namespace ns3
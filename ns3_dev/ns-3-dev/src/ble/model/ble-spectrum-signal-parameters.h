@@ -64,6 +64,19 @@ struct BleSpectrumSignalParameters : public SpectrumSignalParameters
   EventId m_event;
   EventId GetEvent (void);
   void SetEvent (EventId event);  
+  /**
+   * Store the total received power of this signal. It is computed once 
+   * when the signal is delivered to a PHY, as psd no longer changes then.
+   *
+   * \param power the integral of psd in W
+   */
+  void SetRxPower (double power);
+  /**
+   * \return the total received power of this signal in W, or a negative
+   * value if it has not been computed yet
+   */
+  double GetRxPower (void) const;
+  double m_rxPower;
 
 };
 
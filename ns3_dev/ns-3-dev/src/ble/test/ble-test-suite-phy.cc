@@ -0,0 +1,524 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 KULeuven
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+// Include a header file from your module to test.
+#include <ns3/log.h>
+#include <ns3/core-module.h>
+#include <ns3/ble-module.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/enum.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/spectrum-helper.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <cmath>
+
+// An essential include is test.h
+#include "ns3/test.h"
+
+// Do not put your test classes in namespace ns3.  You may find it useful
+// to use the using directive to access the ns3 namespace directly
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ble-phy-test");
+
+// Compares the analytic bit error sampling of the PHY with the
+// exact per-bit sampling.
+class BleTestCaseBitErrors : public TestCase
+{
+public:
+  BleTestCaseBitErrors ();
+  virtual ~BleTestCaseBitErrors ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Draw a number of bit error counts and collect their statistics
+   *
+   * @param mode bit error sampling mode of the PHY
+   * @param bits number of bits per draw
+   * @param ber bit error rate
+   * @param mean returns the mean number of bit errors
+   * @param variance returns the variance of the number of bit errors
+   * @param pZero returns the fraction of draws without bit errors
+   */
+  void Sample (BlePhy::BitErrorSampling mode, int64_t bits, double ber,
+      double &mean, double &variance, double &pZero);
+
+  uint32_t m_draws;
+};
+
+BleTestCaseBitErrors::BleTestCaseBitErrors ()
+  : TestCase ("Ble test case comparing exact and analytic bit error sampling"),
+  m_draws (5000)
+{
+}
+
+BleTestCaseBitErrors::~BleTestCaseBitErrors ()
+{
+}
+
+void
+BleTestCaseBitErrors::Sample (BlePhy::BitErrorSampling mode, int64_t bits,
+    double ber, double &mean, double &variance, double &pZero)
+{
+  Ptr<BlePhy> phy = CreateObject<BlePhy> ();
+  phy->SetAttribute ("BitErrorSampling", EnumValue (mode));
+  double sum = 0;
+  double sumSquares = 0;
+  uint32_t zeros = 0;
+  for (uint32_t i = 0; i < m_draws; i++)
+    {
+      double errors = phy->DrawBitErrors (bits, ber);
+      sum += errors;
+      sumSquares += errors * errors;
+      if (errors == 0)
+        {
+          zeros++;
+        }
+    }
+  mean = sum / m_draws;
+  variance = sumSquares / m_draws - mean * mean;
+  pZero = (double) zeros / m_draws;
+}
+
+void
+BleTestCaseBitErrors::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  double exactMean, exactVariance, exactZero;
+  double analyticMean, analyticVariance, analyticZero;
+
+  // Few expected errors: the analytic mode inverts the binomial CDF.
+  int64_t bits = 1000;
+  double ber = 1e-3;
+  Sample (BlePhy::EXACT_SAMPLING, bits, ber,
+      exactMean, exactVariance, exactZero);
+  Sample (BlePhy::ANALYTIC_SAMPLING, bits, ber,
+      analyticMean, analyticVariance, analyticZero);
+  NS_TEST_ASSERT_MSG_EQ_TOL (exactMean, bits * ber, 0.1,
+      "Exact sampling has a wrong mean");
+  NS_TEST_ASSERT_MSG_EQ_TOL (analyticMean, exactMean, 0.1,
+      "Analytic sampling mean differs from exact sampling");
+  NS_TEST_ASSERT_MSG_EQ_TOL (analyticVariance, exactVariance, 0.15,
+      "Analytic sampling variance differs from exact sampling");
+  NS_TEST_ASSERT_MSG_EQ_TOL (analyticZero, exactZero, 0.03,
+      "Analytic sampling has a different probability of an error free "
+      "interval than exact sampling");
+  NS_TEST_ASSERT_MSG_EQ_TOL (analyticZero, std::pow (1 - ber, bits), 0.03,
+      "Analytic sampling has a wrong probability of an error free interval");
+
+  // Many expected errors: the analytic mode uses the normal approximation.
+  ber = 0.05;
+  Sample (BlePhy::EXACT_SAMPLING, bits, ber,
+      exactMean, exactVariance, exactZero);
+  Sample (BlePhy::ANALYTIC_SAMPLING, bits, ber,
+      analyticMean, analyticVariance, analyticZero);
+  NS_TEST_ASSERT_MSG_EQ_TOL (exactMean, bits * ber, 1,
+      "Exact sampling has a wrong mean");
+  NS_TEST_ASSERT_MSG_EQ_TOL (analyticMean, exactMean, 1,
+      "Analytic sampling mean differs from exact sampling");
+  NS_TEST_ASSERT_MSG_EQ_TOL (analyticVariance, exactVariance, 6,
+      "Analytic sampling variance differs from exact sampling");
+
+  // Edge cases
+  Ptr<BlePhy> phy = CreateObject<BlePhy> ();
+  NS_TEST_ASSERT_MSG_EQ (phy->DrawBitErrors (0, 0.5), 0,
+      "Bit errors drawn in an empty interval");
+  NS_TEST_ASSERT_MSG_EQ (phy->DrawBitErrors (1000, 0), 0,
+      "Bit errors drawn with a zero bit error rate");
+  NS_TEST_ASSERT_MSG_EQ (phy->DrawBitErrors (1000, 1), 1000,
+      "Not all bits are in error with a unit bit error rate");
+}
+
+
+// Checks the accuracy of the BER lookup table of the error model
+class BleTestCaseBerTable : public TestCase
+{
+public:
+  BleTestCaseBerTable ();
+  virtual ~BleTestCaseBerTable ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Compare the table BER with the exact BER over an SNR sweep
+   *
+   * @param model the error model under test
+   * @param relTol allowed relative error where the BER is significant
+   */
+  void CheckAccuracy (Ptr<BleErrorModel> model, double relTol);
+};
+
+BleTestCaseBerTable::BleTestCaseBerTable ()
+  : TestCase ("Ble test case checking the accuracy of the BER lookup table")
+{
+}
+
+BleTestCaseBerTable::~BleTestCaseBerTable ()
+{
+}
+
+void
+BleTestCaseBerTable::CheckAccuracy (Ptr<BleErrorModel> model, double relTol)
+{
+  // BERs below this value are checked with an absolute tolerance
+  double berFloor = 1e-12;
+  for (double snrDb = -15; snrDb < 20; snrDb += 0.0137)
+    {
+      double snr = std::pow (10, snrDb / 10);
+      double exact = model->GetExactBER (snr);
+      double table = model->GetBER (snr);
+      if (exact > berFloor)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (table / exact, 1, relTol,
+              "Table BER differs too much from the exact BER at "
+              << snrDb << " dB");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (table, exact, berFloor,
+              "Table BER differs too much from the exact BER at "
+              << snrDb << " dB");
+        }
+    }
+}
+
+void
+BleTestCaseBerTable::DoRun (void)
+{
+  Ptr<BleErrorModel> model = CreateObject<BleErrorModel> ();
+  CheckAccuracy (model, 1e-3);
+
+  // A finer table must be rebuilt and be more accurate
+  model->SetAttribute ("SnrResolutionDb", DoubleValue (0.01));
+  CheckAccuracy (model, 1e-4);
+
+  model->SetAttribute ("UseLookupTable", BooleanValue (false));
+  NS_TEST_ASSERT_MSG_EQ (model->GetBER (2.5), model->GetExactBER (2.5),
+      "BER is not exact with the lookup table disabled");
+  NS_TEST_ASSERT_MSG_EQ (model->GetBER (0), 0,
+      "BER is not zero without signal");
+}
+
+
+// Checks that the power at the receiving antenna follows the signals
+// that start and end
+class BleTestCaseRxPower : public TestCase
+{
+public:
+  BleTestCaseRxPower ();
+  virtual ~BleTestCaseRxPower ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a signal on a channel
+   *
+   * @param phy the receiving PHY
+   * @param channel the channel index of the signal
+   * @param power the power in the centre band of the signal
+   * @param duration the duration of the signal
+   *
+   * @return the signal parameters
+   */
+  Ptr<BleSpectrumSignalParameters> CreateSignal (Ptr<BlePhy> phy,
+      uint8_t channel, double power, Time duration);
+  void CheckRxPower (Ptr<BlePhy> phy, uint8_t channel, double expected);
+  void ReceptionEnd (Ptr<Packet> packet, bool error);
+
+  uint32_t m_receptions;
+};
+
+BleTestCaseRxPower::BleTestCaseRxPower ()
+  : TestCase ("Ble test case tracking the power at the receiving antenna"),
+  m_receptions (0)
+{
+}
+
+BleTestCaseRxPower::~BleTestCaseRxPower ()
+{
+}
+
+Ptr<BleSpectrumSignalParameters>
+BleTestCaseRxPower::CreateSignal (Ptr<BlePhy> phy, uint8_t channel,
+    double power, Time duration)
+{
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (phy->GetRxSpectrumModel ());
+  (*psd)[channel + 3] = power;
+  (*psd)[channel + 2] = power / 10;
+  (*psd)[channel + 4] = power / 10;
+  Ptr<BleSpectrumSignalParameters> params = 
+    Create<BleSpectrumSignalParameters> ();
+  params->psd = psd;
+  params->duration = duration;
+  params->packet = Create<Packet> (10);
+  params->SetChannel (channel);
+  return params;
+}
+
+void
+BleTestCaseRxPower::CheckRxPower (Ptr<BlePhy> phy, uint8_t channel, 
+    double expected)
+{
+  NS_TEST_ASSERT_MSG_EQ_TOL (phy->GetRxPower (channel), expected, 1e-15,
+      "Wrong power at the receiving antenna at " << Simulator::Now ());
+}
+
+void
+BleTestCaseRxPower::ReceptionEnd (Ptr<Packet> packet, bool error)
+{
+  m_receptions++;
+}
+
+void
+BleTestCaseRxPower::DoRun (void)
+{
+  Ptr<BlePhy> phy = CreateObject<BlePhy> ();
+  phy->SetReceptionEndCallback (
+      MakeCallback (&BleTestCaseRxPower::ReceptionEnd, this));
+  phy->ChangeState (BlePhy::State::RX);
+  phy->ChangeState (BlePhy::State::RX_BUSY);
+
+  uint8_t channel = 10;
+  phy->StartRx (CreateSignal (phy, channel, 1e-9, MicroSeconds (100)));
+  phy->StartRx (CreateSignal (phy, channel, 1e-11, MicroSeconds (200)));
+  CheckRxPower (phy, channel, 1e-9 + 1e-11);
+  CheckRxPower (phy, channel + 1, 1e-10 + 1e-12);
+
+  Simulator::Schedule (MicroSeconds (150), 
+      &BleTestCaseRxPower::CheckRxPower, this, phy, channel, 1e-11);
+  Simulator::Run ();
+
+  CheckRxPower (phy, channel, 0);
+  CheckRxPower (phy, channel + 1, 0);
+  NS_TEST_ASSERT_MSG_EQ (m_receptions, 2, "Not all signals were received");
+  Simulator::Destroy ();
+}
+
+
+// Checks that the shared BLE channel delivers the same power as one
+// MultiModelSpectrumChannel, only to the PHYs tuned close to the signal,
+// also after a receiver moved
+class BleTestCaseSharedChannel : public TestCase
+{
+public:
+  BleTestCaseSharedChannel ();
+  virtual ~BleTestCaseSharedChannel ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario on a channel
+   *
+   * @param channelType the TypeId name of the channel
+   *
+   * @return the power at every channel index of every receiver, after
+   * each of both transmissions
+   */
+  std::vector<double> RunScenario (std::string channelType);
+  static void Transmit (Ptr<SpectrumChannel> channel, Ptr<BlePhy> phy,
+      uint8_t channelIndex);
+  static void Listen (Ptr<BlePhy> phy);
+  static void ReadRxPower (std::vector<double> *powers,
+      std::vector<Ptr<BlePhy> > phys);
+  static void ReceptionEnd (Ptr<Packet> packet, bool error);
+};
+
+BleTestCaseSharedChannel::BleTestCaseSharedChannel ()
+  : TestCase ("Ble test case comparing the shared BLE channel with a "
+      "MultiModelSpectrumChannel")
+{
+}
+
+BleTestCaseSharedChannel::~BleTestCaseSharedChannel ()
+{
+}
+
+void
+BleTestCaseSharedChannel::Transmit (Ptr<SpectrumChannel> channel,
+    Ptr<BlePhy> phy, uint8_t channelIndex)
+{
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (phy->GetRxSpectrumModel ());
+  for (uint8_t band = channelIndex; band <= channelIndex + 6; band++)
+  {
+    (*psd)[band] = (band == channelIndex + 3) ? 1e-9 : 1e-11;
+  }
+  Ptr<BleSpectrumSignalParameters> params = 
+    Create<BleSpectrumSignalParameters> ();
+  params->psd = psd;
+  params->txPhy = phy;
+  params->duration = MicroSeconds (100);
+  params->packet = Create<Packet> (10);
+  params->SetChannel (channelIndex);
+  channel->StartTx (params);
+}
+
+void
+BleTestCaseSharedChannel::Listen (Ptr<BlePhy> phy)
+{
+  phy->ChangeState (BlePhy::State::IDLE);
+  phy->ChangeState (BlePhy::State::RX);
+  phy->ChangeState (BlePhy::State::RX_BUSY);
+}
+
+void
+BleTestCaseSharedChannel::ReadRxPower (std::vector<double> *powers,
+    std::vector<Ptr<BlePhy> > phys)
+{
+  for (auto &phy : phys)
+  {
+    for (uint8_t channelIndex = 0; channelIndex < 37; channelIndex++)
+    {
+      powers->push_back (phy->GetRxPower (channelIndex));
+    }
+  }
+}
+
+void
+BleTestCaseSharedChannel::ReceptionEnd (Ptr<Packet> packet, bool error)
+{
+}
+
+std::vector<double>
+BleTestCaseSharedChannel::RunScenario (std::string channelType)
+{
+  SpectrumChannelHelper channelHelper;
+  channelHelper.SetChannel (channelType);
+  channelHelper.AddPropagationLoss ("ns3::LogDistancePropagationLossModel");
+  channelHelper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  Ptr<SpectrumChannel> channel = channelHelper.Create ();
+
+  // transmitter, receiver on the same index, receiver on an adjacent
+  // index and receiver far from the transmitted index
+  double x[] = {0, 10, 20, 5};
+  uint8_t channelIndices[] = {10, 10, 12, 20};
+  std::vector<Ptr<BlePhy> > phys;
+  for (uint32_t i = 0; i < 4; i++)
+  {
+    Ptr<BlePhy> phy = CreateObject<BlePhy> ();
+    if (i > 0)
+    {
+      phy->SetRxSpectrumModel (phys[0]->GetRxSpectrumModel ());
+    }
+    Ptr<MobilityModel> mobility = 
+      CreateObject<ConstantPositionMobilityModel> ();
+    mobility->SetPosition (Vector (x[i], 0, 1.5));
+    phy->SetMobility (mobility);
+    phy->SetChannel (channel);
+    phy->SetChannelIndex (channelIndices[i]);
+    phy->SetReceptionEndCallback (
+        MakeCallback (&BleTestCaseSharedChannel::ReceptionEnd));
+    if (i > 0)
+    {
+      Listen (phy);
+    }
+    phys.push_back (phy);
+  }
+  std::vector<Ptr<BlePhy> > receivers (phys.begin () + 1, phys.end ());
+
+  std::vector<double> powers;
+  Simulator::Schedule (MicroSeconds (0), &BleTestCaseSharedChannel::Transmit,
+      channel, phys[0], 10);
+  Simulator::Schedule (MicroSeconds (50), &BleTestCaseSharedChannel::ReadRxPower,
+      &powers, receivers);
+  // move the first receiver away, tune the adjacent receiver away and
+  // the far receiver to an adjacent index, and listen again
+  Simulator::Schedule (MilliSeconds (1), &MobilityModel::SetPosition,
+      phys[1]->GetMobility (), Vector (40, 0, 1.5));
+  Simulator::Schedule (MilliSeconds (1), &BlePhy::SetChannelIndex,
+      phys[2], 25);
+  Simulator::Schedule (MilliSeconds (1), &BlePhy::SetChannelIndex,
+      phys[3], 9);
+  for (auto &phy : receivers)
+  {
+    Simulator::Schedule (MilliSeconds (1), &BleTestCaseSharedChannel::Listen,
+        phy);
+  }
+  Simulator::Schedule (MilliSeconds (2), &BleTestCaseSharedChannel::Transmit,
+      channel, phys[0], 10);
+  Simulator::Schedule (MilliSeconds (2) + MicroSeconds (50), 
+      &BleTestCaseSharedChannel::ReadRxPower, &powers, receivers);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  channel->Dispose ();
+  return powers;
+}
+
+void
+BleTestCaseSharedChannel::DoRun (void)
+{
+  std::vector<double> multi = RunScenario ("ns3::MultiModelSpectrumChannel");
+  std::vector<double> shared = RunScenario ("ns3::BleSpectrumChannel");
+  NS_TEST_ASSERT_MSG_EQ (shared.size (), multi.size (),
+      "Different number of samples");
+  for (uint32_t i = 0; i < multi.size (); i++)
+  {
+    uint32_t receiver = (i / 37) % 3;
+    bool first = i < 3 * 37;
+    if ((first && receiver == 2) || (!first && receiver == 1))
+    {
+      // the receiver tuned far away is not reached by the shared channel
+      NS_TEST_ASSERT_MSG_EQ (shared[i], 0, "Far receiver got a signal");
+    }
+    else
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (shared[i], multi[i], 1e-6 * multi[i],
+          "Different power at receiver " << receiver << " index " << i % 37);
+    }
+  }
+  // the moved receiver gets less power from the second transmission
+  NS_TEST_ASSERT_MSG_LT (shared[3 * 37 + 10], shared[10],
+      "Moving the receiver did not change the link budget");
+  NS_TEST_ASSERT_MSG_GT (shared[3 * 37 + 10], 0, "No second reception");
+  // the receiver that tuned next to the transmitted index gets it
+  NS_TEST_ASSERT_MSG_GT (shared[5 * 37 + 10], 0,
+      "No reception after tuning to an adjacent index");
+}
+
+
+// The TestSuite class names the TestSuite, identifies what type of TestSuite,
+// and enables the TestCases to be run.  Typically, only the constructor for
+// this class must be defined
+//
+class BleTestSuitePhy : public TestSuite
+{
+public:
+  BleTestSuitePhy ();
+};
+
+BleTestSuitePhy::BleTestSuitePhy ()
+  : TestSuite ("ble3", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new BleTestCaseBitErrors, TestCase::QUICK);
+  AddTestCase (new BleTestCaseBerTable, TestCase::QUICK);
+  AddTestCase (new BleTestCaseRxPower, TestCase::QUICK);
+  AddTestCase (new BleTestCaseSharedChannel, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static BleTestSuitePhy bleTestSuitePhy;
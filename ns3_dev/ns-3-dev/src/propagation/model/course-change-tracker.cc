@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "course-change-tracker.h"
+#include "ns3/log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CourseChangeTracker");
+
+/// Smallest number of tracked models that triggers Prune
+static const std::size_t MIN_PRUNE_SIZE = 64;
+
+CourseChangeTracker::CourseChangeTracker ()
+  : m_lastEpoch (0),
+    m_pruneSize (MIN_PRUNE_SIZE)
+{
+}
+
+CourseChangeTracker::~CourseChangeTracker ()
+{
+  Clear ();
+}
+
+bool
+CourseChangeTracker::GetEpoch (Ptr<const MobilityModel> mobility, uint64_t &epoch)
+{
+  if (mobility->GetVelocity ().GetLength () != 0)
+    {
+      // the position changes without a course change
+      return false;
+    }
+  std::map<Ptr<const MobilityModel>, uint64_t>::iterator it = m_epochs.find (mobility);
+  if (it == m_epochs.end ())
+    {
+      if (m_epochs.size () >= m_pruneSize)
+        {
+          Prune ();
+        }
+      NS_LOG_LOGIC ("Tracking the course changes of " << mobility);
+      it = m_epochs.insert (std::make_pair (mobility, ++m_lastEpoch)).first;
+      ConstCast<MobilityModel> (mobility)->TraceConnectWithoutContext (
+        "CourseChange", MakeCallback (&CourseChangeTracker::CourseChanged, this));
+    }
+  epoch = it->second;
+  return true;
+}
+
+void
+CourseChangeTracker::Prune (void)
+{
+  std::map<Ptr<const MobilityModel>, uint64_t>::iterator it = m_epochs.begin ();
+  while (it != m_epochs.end ())
+    {
+      if (IsOrphan (it->first))
+        {
+          Disconnect (it->first);
+          it = m_epochs.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+  m_pruneSize = std::max (MIN_PRUNE_SIZE, 2 * m_epochs.size ());
+  NS_LOG_LOGIC ("Tracking " << m_epochs.size () << " models after pruning");
+}
+
+void
+CourseChangeTracker::Clear (void)
+{
+  for (auto &epoch : m_epochs)
+    {
+      Disconnect (epoch.first);
+    }
+  m_epochs.clear ();
+  m_pruneSize = MIN_PRUNE_SIZE;
+}
+
+std::size_t
+CourseChangeTracker::GetN (void) const
+{
+  return m_epochs.size ();
+}
+
+void
+CourseChangeTracker::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  m_epochs[mobility] = ++m_lastEpoch;
+}
+
+bool
+CourseChangeTracker::IsOrphan (Ptr<const MobilityModel> mobility)
+{
+  // the model lives as long as its aggregate, e.g. a node
+  uint32_t aggregated = 0;
+  {
+    Object::AggregateIterator it = mobility->GetAggregateIterator ();
+    while (it.HasNext ())
+      {
+        it.Next ();
+        aggregated++;
+      }
+  }
+  // references of the map and of the argument
+  return aggregated <= 1 && mobility->GetReferenceCount () <= 2;
+}
+
+void
+CourseChangeTracker::Disconnect (Ptr<const MobilityModel> mobility)
+{
+  ConstCast<MobilityModel> (mobility)->TraceDisconnectWithoutContext (
+    "CourseChange", MakeCallback (&CourseChangeTracker::CourseChanged, this));
+}
+
+} // namespace ns3
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef COURSE_CHANGE_TRACKER_H
+#define COURSE_CHANGE_TRACKER_H
+
+#include "ns3/mobility-model.h"
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ * \brief Tells when values computed from the positions of mobility models
+ * become stale.
+ *
+ * Every tracked mobility model has an epoch, which changes with each course
+ * change notified by the model. A value cached together with the epochs of
+ * its models is current as long as these epochs are unchanged. Epochs are
+ * taken from one counter, so a model never gets an epoch that another model
+ * had before, even if it is allocated at the address of a model that was
+ * destroyed.
+ *
+ * Models that are not aggregated to anything and only referenced by the
+ * tracker are no longer tracked, so that models created for a single query
+ * are released. This is checked when the number of tracked models doubled.
+ */
+class CourseChangeTracker
+{
+public:
+  CourseChangeTracker ();
+  ~CourseChangeTracker ();
+
+  /**
+   * \brief Get the epoch of a mobility model, starting to track it if needed.
+   *
+   * \param mobility the mobility model
+   * \param epoch returns the epoch of the model
+   * \returns false if the model moves, as its position then changes without
+   * a course change and values involving it must not be cached
+   */
+  bool GetEpoch (Ptr<const MobilityModel> mobility, uint64_t &epoch);
+
+  /**
+   * \brief Stop tracking the models that are only referenced by the tracker.
+   */
+  void Prune (void);
+
+  /**
+   * \brief Stop tracking all models.
+   */
+  void Clear (void);
+
+  /**
+   * \returns the number of tracked models
+   */
+  std::size_t GetN (void) const;
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented, the tracked models call back this instance
+   */
+  CourseChangeTracker (const CourseChangeTracker &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented, the tracked models call back this instance
+   * \returns
+   */
+  CourseChangeTracker &operator = (const CourseChangeTracker &);
+
+  /**
+   * \brief Give a new epoch to a tracked model.
+   *
+   * \param mobility the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  /**
+   * \param mobility a tracked mobility model
+   * \returns whether nothing but the tracker keeps the model alive
+   */
+  static bool IsOrphan (Ptr<const MobilityModel> mobility);
+
+  /**
+   * \brief Stop receiving the course changes of a model.
+   *
+   * \param mobility the mobility model
+   */
+  void Disconnect (Ptr<const MobilityModel> mobility);
+
+  std::map<Ptr<const MobilityModel>, uint64_t> m_epochs; //!< epoch per tracked model
+  uint64_t m_lastEpoch; //!< last epoch given to a model
+  std::size_t m_pruneSize; //!< number of tracked models that triggers Prune
+};
+
+} // namespace ns3
+
+#endif /* COURSE_CHANGE_TRACKER_H */
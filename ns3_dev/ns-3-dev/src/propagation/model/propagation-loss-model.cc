@@ -28,6 +28,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <cmath>
 
 namespace ns3 {
@@ -932,4 +933,108 @@ RangePropagationLossModel::DoAssignStreams (int64_t stream)
 
 // ------------------------------------------------------------------------- //
 
+NS_OBJECT_ENSURE_REGISTERED (CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedPropagationLossModel")
+    .SetParent<PropagationLossModel> ()
+    .SetGroupName ("Propagation")
+    .AddConstructor<CachedPropagationLossModel> ()
+    .AddAttribute ("LossModel",
+                   "The deterministic propagation loss model whose loss is cached.",
+                   PointerValue (),
+                   MakePointerAccessor (&CachedPropagationLossModel::SetLossModel,
+                                        &CachedPropagationLossModel::GetLossModel),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("CacheSize",
+                   "Maximum number of cached pairs of mobility models. "
+                   "The cache is emptied when it is full.",
+                   UintegerValue (1000000),
+                   MakeUintegerAccessor (&CachedPropagationLossModel::m_cacheSize),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel ()
+{
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel ()
+{
+}
+
+void
+CachedPropagationLossModel::DoDispose (void)
+{
+  m_tracker.Clear ();
+  m_cache.clear ();
+  m_lossModel = 0;
+  PropagationLossModel::DoDispose ();
+}
+
+void
+CachedPropagationLossModel::SetLossModel (Ptr<PropagationLossModel> model)
+{
+  m_lossModel = model;
+  m_cache.clear ();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetLossModel (void) const
+{
+  return m_lossModel;
+}
+
+std::size_t
+CachedPropagationLossModel::GetCacheEntries (void) const
+{
+  return m_cache.size ();
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower (double txPowerDbm,
+                                           Ptr<MobilityModel> a,
+                                           Ptr<MobilityModel> b) const
+{
+  NS_ASSERT_MSG (m_lossModel, "No LossModel set for the CachedPropagationLossModel");
+  uint64_t aEpoch;
+  uint64_t bEpoch;
+  if (!m_tracker.GetEpoch (a, aEpoch) || !m_tracker.GetEpoch (b, bEpoch))
+    {
+      return m_lossModel->CalcRxPower (txPowerDbm, a, b);
+    }
+  MobilityPair key (PeekPointer (a), PeekPointer (b));
+  std::map<MobilityPair, CacheEntry>::iterator it = m_cache.find (key);
+  if (it != m_cache.end () && it->second.m_aEpoch == aEpoch && it->second.m_bEpoch == bEpoch)
+    {
+      return txPowerDbm + it->second.m_gainDb;
+    }
+  double rxPowerDbm = m_lossModel->CalcRxPower (txPowerDbm, a, b);
+  if (it == m_cache.end () && m_cache.size () >= m_cacheSize)
+    {
+      m_cache.clear ();
+      m_tracker.Prune ();
+    }
+  CacheEntry &entry = m_cache[key];
+  entry.m_gainDb = rxPowerDbm - txPowerDbm;
+  entry.m_aEpoch = aEpoch;
+  entry.m_bEpoch = bEpoch;
+  return rxPowerDbm;
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams (int64_t stream)
+{
+  if (m_lossModel)
+    {
+      return m_lossModel->AssignStreams (stream);
+    }
+  return 0;
+}
+
+// ------------------------------------------------------------------------- //
+
 } // namespace ns3
@@ -27,6 +27,7 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "course-change-tracker.h"
 #include <map>
 
 namespace ns3 {
@@ -856,6 +857,90 @@ private:
   double m_range; //!< Maximum Transmission Range (meters)
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief Memoizes the loss of another model per pair of mobility models.
+ *
+ * The loss computed by the LossModel attribute (including the models
+ * chained to it) is reused for a pair of mobility models until one of
+ * both notifies a course change. Pairs involving a mobility model with a
+ * non-zero velocity are never cached, since their positions change
+ * without notification. The cached model must be deterministic and its
+ * loss in dB must not depend on the transmit power, which holds for the
+ * usual distance-based models. Random models such as
+ * NakagamiPropagationLossModel can still be chained after this model
+ * with SetNext.
+ *
+ * The cache holds at most CacheSize pairs and is emptied when it is full.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedPropagationLossModel ();
+  virtual ~CachedPropagationLossModel ();
+
+  /**
+   * \param model the propagation loss model whose loss is cached
+   */
+  void SetLossModel (Ptr<PropagationLossModel> model);
+
+  /**
+   * \return the propagation loss model whose loss is cached
+   */
+  Ptr<PropagationLossModel> GetLossModel (void) const;
+
+  /**
+   * \return the number of cached pairs
+   */
+  std::size_t GetCacheEntries (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   */
+  CachedPropagationLossModel (const CachedPropagationLossModel &);
+  /**
+   * \brief Copy constructor
+   *
+   * Defined and unimplemented to avoid misuse
+   * \returns
+   */
+  CachedPropagationLossModel &operator = (const CachedPropagationLossModel &);
+
+  virtual double DoCalcRxPower (double txPowerDbm,
+                                Ptr<MobilityModel> a,
+                                Ptr<MobilityModel> b) const;
+  virtual int64_t DoAssignStreams (int64_t stream);
+
+  /// Cached loss of a pair of mobility models
+  struct CacheEntry
+  {
+    double m_gainDb;     //!< received minus transmitted power (dB)
+    uint64_t m_aEpoch;   //!< epoch of the source
+    uint64_t m_bEpoch;   //!< epoch of the destination
+  };
+
+  /// Typedef: Mobility models pair
+  typedef std::pair<const MobilityModel *, const MobilityModel *> MobilityPair;
+
+  Ptr<PropagationLossModel> m_lossModel; //!< model whose loss is cached
+  uint32_t m_cacheSize; //!< maximum number of cached pairs
+  mutable std::map<MobilityPair, CacheEntry> m_cache; //!< cached losses
+  mutable CourseChangeTracker m_tracker; //!< epochs of the mobility models
+};
+
 } // namespace ns3
 
 #endif /* PROPAGATION_LOSS_MODEL_H */
@@ -23,7 +23,12 @@
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include "ns3/simulator.h"
+#include "ns3/course-change-tracker.h"
+#include "ns3/node.h"
 
 using namespace ns3;
 
@@ -436,6 +441,127 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class CachedPropagationLossModelTestCase : public TestCase
+{
+public:
+  CachedPropagationLossModelTestCase ();
+  virtual ~CachedPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase ()
+  : TestCase ("Test CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase ()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (20,0,0));
+  Ptr<ConstantVelocityMobilityModel> c = CreateObject<ConstantVelocityMobilityModel> ();
+  c->SetPosition (Vector (0,30,0));
+  c->SetVelocity (Vector (1,0,0));
+
+  Ptr<LogDistancePropagationLossModel> reference = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<CachedPropagationLossModel> lossModel = CreateObject<CachedPropagationLossModel> ();
+  lossModel->SetAttribute ("LossModel", PointerValue (reference));
+  lossModel->SetAttribute ("CacheSize", UintegerValue (2));
+
+  double tolerance = 1e-9;
+  double expected = reference->CalcRxPower (0, a, b);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, b), expected, tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetCacheEntries (), 1, "Static pair not cached");
+  // the cached loss applies to any transmit power
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (10, a, b), expected + 10, tolerance, "Got unexpected cached rcv power");
+
+  // a course change invalidates the cached loss
+  b->SetPosition (Vector (50,0,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, b), reference->CalcRxPower (0, a, b), tolerance, "Got stale rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetCacheEntries (), 1, "Course change did not replace the entry");
+
+  // pairs with a moving model are not cached
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, c), reference->CalcRxPower (0, a, c), tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetCacheEntries (), 1, "Moving pair cached");
+  c->SetVelocity (Vector (0,0,0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, a, c), reference->CalcRxPower (0, a, c), tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_EQ (lossModel->GetCacheEntries (), 2, "Stopped pair not cached");
+
+  // the cache never exceeds its capacity
+  NS_TEST_EXPECT_MSG_EQ_TOL (lossModel->CalcRxPower (0, b, c), reference->CalcRxPower (0, b, c), tolerance, "Got unexpected rcv power");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (lossModel->GetCacheEntries (), 2, "Cache exceeds its capacity");
+  lossModel->Dispose ();
+  Simulator::Destroy ();
+}
+
+class CourseChangeTrackerTestCase : public TestCase
+{
+public:
+  CourseChangeTrackerTestCase ();
+  virtual ~CourseChangeTrackerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CourseChangeTrackerTestCase::CourseChangeTrackerTestCase ()
+  : TestCase ("Test CourseChangeTracker")
+{
+}
+
+CourseChangeTrackerTestCase::~CourseChangeTrackerTestCase ()
+{
+}
+
+void
+CourseChangeTrackerTestCase::DoRun (void)
+{
+  CourseChangeTracker tracker;
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantVelocityMobilityModel> b = CreateObject<ConstantVelocityMobilityModel> ();
+  b->SetVelocity (Vector (1,0,0));
+  Ptr<Node> node = CreateObject<Node> ();
+  node->AggregateObject (CreateObject<ConstantPositionMobilityModel> ());
+
+  uint64_t epoch;
+  uint64_t aEpoch;
+  uint64_t nodeEpoch;
+  NS_TEST_ASSERT_MSG_EQ (tracker.GetEpoch (a, aEpoch), true, "Static model not tracked");
+  NS_TEST_EXPECT_MSG_EQ (tracker.GetEpoch (a, epoch) && epoch == aEpoch, true, "Epoch changed without a course change");
+  NS_TEST_EXPECT_MSG_EQ (tracker.GetEpoch (b, epoch), false, "Moving model tracked");
+  NS_TEST_ASSERT_MSG_EQ (tracker.GetEpoch (node->GetObject<MobilityModel> (), nodeEpoch), true, "Static model not tracked");
+
+  // a course change gives a new epoch
+  a->SetPosition (Vector (10,0,0));
+  NS_TEST_EXPECT_MSG_EQ (tracker.GetEpoch (a, epoch) && epoch != aEpoch && epoch != nodeEpoch, true, "Course change not noticed");
+  aEpoch = epoch;
+
+  // models only used for one query are released, the others stay tracked
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Ptr<MobilityModel> temporary = CreateObject<ConstantPositionMobilityModel> ();
+      NS_TEST_ASSERT_MSG_EQ (tracker.GetEpoch (temporary, epoch), true, "Static model not tracked");
+      NS_TEST_ASSERT_MSG_GT (epoch, aEpoch, "Epoch given twice");
+    }
+  NS_TEST_EXPECT_MSG_LT (tracker.GetN (), 100, "Temporary models are still tracked");
+  NS_TEST_EXPECT_MSG_EQ (tracker.GetEpoch (a, epoch) && epoch == aEpoch, true, "Referenced model no longer tracked");
+  NS_TEST_EXPECT_MSG_EQ (tracker.GetEpoch (node->GetObject<MobilityModel> (), epoch) && epoch == nodeEpoch, true,
+                         "Model of a node no longer tracked");
+
+  tracker.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (tracker.GetN (), 0, "Models still tracked after Clear");
+  node->Dispose ();
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +576,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CachedPropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new CourseChangeTrackerTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
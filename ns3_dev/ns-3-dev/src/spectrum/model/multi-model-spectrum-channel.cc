@@ -19,6 +19,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <utility>
 #include <ns3/object.h>
@@ -79,7 +80,9 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
-  : m_numDevices {0}
+  : m_numDevices {0},
+    m_maxRange {0},
+    m_rxGridValid {false}
 {
   NS_LOG_FUNCTION (this);
 }
@@ -88,6 +91,12 @@ void
 MultiModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  for (auto &mobility : m_rxTrackedMobility)
+    {
+      mobility->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::RxCourseChanged, this));
+    }
+  m_rxTrackedMobility.clear ();
+  m_rxGridEntries.clear ();
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
   SpectrumChannel::DoDispose ();
@@ -100,7 +109,18 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("MaxRange",
+                   "If positive, receivers farther than this distance (in m) "
+                   "from the transmitter are not considered at all, and the "
+                   "receivers are kept in a spatial grid so that only the "
+                   "ones close to the transmitter are visited. This value "
+                   "must be such that any receiver beyond it has a loss "
+                   "bigger than MaxLossDb. The default value disables the "
+                   "culling.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::SetMaxRange,
+                                       &MultiModelSpectrumChannel::GetMaxRange),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
@@ -134,6 +154,8 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
     }
 
   ++m_numDevices;
+  // the indices of the receivers may have changed
+  m_rxGridValid = false;
 
   RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.find (rxSpectrumModelUid);
 
@@ -235,6 +257,12 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  bool culling = (m_maxRange > 0) && txMobility;
+  if (culling && !m_rxGridValid)
+    {
+      BuildRxGrid ();
+    }
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -260,8 +288,20 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
-      for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhys.end ();
+      std::vector<Ptr<SpectrumPhy> > culledRxPhys;
+      if (culling)
+        {
+          std::vector<std::size_t> candidates = GetRxCandidates (rxInfoIterator->second, txMobility->GetPosition ());
+          culledRxPhys.reserve (candidates.size ());
+          for (std::size_t i : candidates)
+            {
+              culledRxPhys.push_back (rxInfoIterator->second.m_rxPhys[i]);
+            }
+        }
+      const std::vector<Ptr<SpectrumPhy> > &rxPhys = culling ? culledRxPhys : rxInfoIterator->second.m_rxPhys;
+
+      for (auto rxPhyIterator = rxPhys.begin ();
+           rxPhyIterator != rxPhys.end ();
            ++rxPhyIterator)
         {
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
@@ -269,13 +309,18 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
+              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+              if (culling && receiverMobility && txMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+                {
+                  // beyond range
+                  continue;
+                }
+
               NS_LOG_LOGIC ("copying signal parameters " << txParams);
               Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
               rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
               Time delay = MicroSeconds (0);
 
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-
               if (txMobility && receiverMobility)
                 {
                   double txAntennaGain = 0;
@@ -355,6 +400,142 @@ MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<Sp
   receiver->StartRx (params);
 }
 
+void
+MultiModelSpectrumChannel::SetMaxRange (double maxRange)
+{
+  NS_LOG_FUNCTION (this << maxRange);
+  m_maxRange = maxRange;
+  m_rxGridValid = false;
+}
+
+double
+MultiModelSpectrumChannel::GetMaxRange (void) const
+{
+  return m_maxRange;
+}
+
+RxGridCell_t
+MultiModelSpectrumChannel::GetRxGridCell (const Vector &position) const
+{
+  return RxGridCell_t (static_cast<int64_t> (std::floor (position.x / m_maxRange)),
+                       static_cast<int64_t> (std::floor (position.y / m_maxRange)));
+}
+
+void
+MultiModelSpectrumChannel::BuildRxGrid (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rxGridEntries.clear ();
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+       rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
+       ++rxInfoIterator)
+    {
+      RxSpectrumModelInfo &rxInfo = rxInfoIterator->second;
+      rxInfo.m_rxGrid.clear ();
+      rxInfo.m_rxUnindexed.clear ();
+      for (std::size_t i = 0; i < rxInfo.m_rxPhys.size (); ++i)
+        {
+          Ptr<MobilityModel> mobility = rxInfo.m_rxPhys[i]->GetMobility ();
+          if (mobility == 0)
+            {
+              rxInfo.m_rxUnindexed.push_back (i);
+              continue;
+            }
+          if (m_rxTrackedMobility.insert (mobility).second)
+            {
+              mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&MultiModelSpectrumChannel::RxCourseChanged, this));
+            }
+          RxGridEntry entry;
+          entry.m_rxSpectrumModelUid = rxInfoIterator->first;
+          entry.m_index = i;
+          InsertRxGridEntry (rxInfo, entry, mobility);
+          m_rxGridEntries[mobility].push_back (entry);
+        }
+    }
+  m_rxGridValid = true;
+}
+
+void
+MultiModelSpectrumChannel::InsertRxGridEntry (RxSpectrumModelInfo &rxInfo, RxGridEntry &entry,
+                                              Ptr<const MobilityModel> mobility)
+{
+  // a moving receiver may leave its cell without a course change
+  entry.m_indexed = (mobility->GetVelocity ().GetLength () == 0);
+  std::vector<std::size_t> *indices = &rxInfo.m_rxUnindexed;
+  if (entry.m_indexed)
+    {
+      entry.m_cell = GetRxGridCell (mobility->GetPosition ());
+      indices = &rxInfo.m_rxGrid[entry.m_cell];
+    }
+  indices->insert (std::lower_bound (indices->begin (), indices->end (), entry.m_index), entry.m_index);
+}
+
+void
+MultiModelSpectrumChannel::RemoveRxGridEntry (RxSpectrumModelInfo &rxInfo, const RxGridEntry &entry)
+{
+  if (entry.m_indexed)
+    {
+      RxGrid_t::iterator cellIterator = rxInfo.m_rxGrid.find (entry.m_cell);
+      NS_ASSERT (cellIterator != rxInfo.m_rxGrid.end ());
+      std::vector<std::size_t> &indices = cellIterator->second;
+      indices.erase (std::lower_bound (indices.begin (), indices.end (), entry.m_index));
+      if (indices.empty ())
+        {
+          rxInfo.m_rxGrid.erase (cellIterator);
+        }
+    }
+  else
+    {
+      std::vector<std::size_t> &indices = rxInfo.m_rxUnindexed;
+      indices.erase (std::lower_bound (indices.begin (), indices.end (), entry.m_index));
+    }
+}
+
+std::vector<std::size_t>
+MultiModelSpectrumChannel::GetRxCandidates (const RxSpectrumModelInfo &rxInfo,
+                                            const Vector &position) const
+{
+  std::vector<std::size_t> candidates (rxInfo.m_rxUnindexed);
+  RxGridCell_t cell = GetRxGridCell (position);
+  for (int64_t x = cell.first - 1; x <= cell.first + 1; ++x)
+    {
+      for (int64_t y = cell.second - 1; y <= cell.second + 1; ++y)
+        {
+          RxGrid_t::const_iterator cellIterator = rxInfo.m_rxGrid.find (RxGridCell_t (x, y));
+          if (cellIterator != rxInfo.m_rxGrid.end ())
+            {
+              candidates.insert (candidates.end (), cellIterator->second.begin (), cellIterator->second.end ());
+            }
+        }
+    }
+  // keep the order of m_rxPhys, so that receptions are scheduled in
+  // the same order as without culling
+  std::sort (candidates.begin (), candidates.end ());
+  return candidates;
+}
+
+void
+MultiModelSpectrumChannel::RxCourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  if (!m_rxGridValid)
+    {
+      // the grid is rebuilt from scratch before the next transmission
+      return;
+    }
+  std::map<Ptr<const MobilityModel>, std::vector<RxGridEntry> >::iterator entriesIterator = m_rxGridEntries.find (mobility);
+  if (entriesIterator == m_rxGridEntries.end ())
+    {
+      return;
+    }
+  for (auto &entry : entriesIterator->second)
+    {
+      RxSpectrumModelInfo &rxInfo = m_rxSpectrumModelInfoMap.find (entry.m_rxSpectrumModelUid)->second;
+      RemoveRxGridEntry (rxInfo, entry);
+      InsertRxGridEntry (rxInfo, entry, mobility);
+    }
+}
+
 std::size_t
 MultiModelSpectrumChannel::GetNDevices (void) const
 {
@@ -27,6 +27,7 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/vector.h>
 #include <map>
 #include <set>
 
@@ -65,6 +66,19 @@ public:
 typedef std::map<SpectrumModelUid_t, TxSpectrumModelInfo> TxSpectrumModelInfoMap_t;
 
 
+/**
+ * \ingroup spectrum
+ * Cell of the spatial grid used to cull receivers, as (x, y) cell indices
+ */
+typedef std::pair<int64_t, int64_t> RxGridCell_t;
+
+/**
+ * \ingroup spectrum
+ * Container: RxGridCell_t, indices of the receivers in that cell
+ */
+typedef std::map<RxGridCell_t, std::vector<std::size_t> > RxGrid_t;
+
+
 /**
  * \ingroup spectrum
  * The Rx spectrum model information. This class is used to convert
@@ -81,6 +95,8 @@ public:
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;  //!< Rx Spectrum model.
   std::vector<Ptr<SpectrumPhy> > m_rxPhys;     //!< Container of the Rx Spectrum phy objects.
+  RxGrid_t m_rxGrid;                           //!< Indices in m_rxPhys of the static Rx phys, per grid cell.
+  std::vector<std::size_t> m_rxUnindexed;      //!< Indices in m_rxPhys of the Rx phys that are always considered.
 };
 
 /**
@@ -102,6 +118,18 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * \note When the MaxRange attribute is set, receivers farther than
+ * MaxRange from the transmitter are not considered at all. The
+ * receivers are then kept in a uniform grid of MaxRange sized cells
+ * on their (x, y) position, which is refreshed on the CourseChange
+ * trace of their MobilityModel, so that a transmission only visits
+ * the receivers in the 3x3 cells around the transmitter. Receivers
+ * that move (non-zero velocity) or have no MobilityModel are always
+ * visited. As long as every receiver beyond MaxRange has a loss larger
+ * than MaxLossDb, the delivered signals are identical to those without
+ * culling, provided the PropagationLossModel does not draw random
+ * variables.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -124,6 +152,16 @@ public:
   virtual std::size_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * \param maxRange the distance in m beyond which receivers are not
+   * considered, or 0 to consider all receivers
+   */
+  void SetMaxRange (double maxRange);
+  /**
+   * \return the distance in m beyond which receivers are not considered
+   */
+  double GetMaxRange (void) const;
+
 
 protected:
   void DoDispose ();
@@ -149,6 +187,63 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Position of a receiver in the spatial grid of one RX SpectrumModel
+   */
+  struct RxGridEntry
+  {
+    SpectrumModelUid_t m_rxSpectrumModelUid;  //!< RX SpectrumModel of the receiver.
+    std::size_t m_index;                      //!< Index of the receiver in m_rxPhys.
+    bool m_indexed;                           //!< Whether the receiver is in m_rxGrid or in m_rxUnindexed.
+    RxGridCell_t m_cell;                      //!< Grid cell of the receiver, if indexed.
+  };
+
+  /**
+   * \param position a position
+   * \return the grid cell containing the position
+   */
+  RxGridCell_t GetRxGridCell (const Vector &position) const;
+
+  /**
+   * (Re)build the spatial grid of all RX SpectrumModels.
+   */
+  void BuildRxGrid (void);
+
+  /**
+   * Add a receiver to the spatial grid according to its current
+   * position and velocity.
+   *
+   * \param rxInfo the information of the RX SpectrumModel of the receiver
+   * \param entry the grid entry of the receiver, updated with its cell
+   * \param mobility the mobility model of the receiver
+   */
+  void InsertRxGridEntry (RxSpectrumModelInfo &rxInfo, RxGridEntry &entry,
+                          Ptr<const MobilityModel> mobility);
+
+  /**
+   * Remove a receiver from the spatial grid.
+   *
+   * \param rxInfo the information of the RX SpectrumModel of the receiver
+   * \param entry the grid entry of the receiver
+   */
+  void RemoveRxGridEntry (RxSpectrumModelInfo &rxInfo, const RxGridEntry &entry);
+
+  /**
+   * \param rxInfo the information of an RX SpectrumModel
+   * \param position the position of the transmitter
+   * \return the indices in m_rxPhys, in ascending order, of the receivers
+   * that may be within MaxRange of position
+   */
+  std::vector<std::size_t> GetRxCandidates (const RxSpectrumModelInfo &rxInfo,
+                                            const Vector &position) const;
+
+  /**
+   * Move the receivers using a mobility model to their new grid cell.
+   *
+   * \param mobility the mobility model whose course changed
+   */
+  void RxCourseChanged (Ptr<const MobilityModel> mobility);
+
   /**
    * Data structure holding, for each TX SpectrumModel,  all the
    * converters to any RX SpectrumModel, and all the corresponding
@@ -169,6 +264,26 @@ private:
    */
   std::size_t m_numDevices;
 
+  /**
+   * Distance beyond which receivers are not considered, 0 if disabled.
+   */
+  double m_maxRange;
+
+  /**
+   * Whether the spatial grid is up to date with the registered receivers.
+   */
+  bool m_rxGridValid;
+
+  /**
+   * Grid entries of the receivers, per mobility model.
+   */
+  std::map<Ptr<const MobilityModel>, std::vector<RxGridEntry> > m_rxGridEntries;
+
+  /**
+   * Mobility models whose CourseChange trace is connected.
+   */
+  std::set<Ptr<MobilityModel> > m_rxTrackedMobility;
+
 };
 
 
@@ -0,0 +1,253 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/object.h>
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-model-ism2400MHz-res1MHz.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <tuple>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumChannelCullingTest");
+
+/// Reception: time, transmitter id, receiver id, received power
+typedef std::tuple<int64_t, uint32_t, uint32_t, double> CullingTestReception;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Minimal SpectrumPhy logging the signals it receives
+ */
+class CullingTestPhy : public SpectrumPhy
+{
+public:
+  /**
+   * Constructor
+   * \param id identifier of the phy
+   * \param receptions log of the receptions of all phys
+   */
+  CullingTestPhy (uint32_t id, std::vector<CullingTestReception> *receptions)
+    : m_id (id),
+      m_receptions (receptions)
+  {
+  }
+
+  /// \return the identifier of the phy
+  uint32_t GetId (void) const
+  {
+    return m_id;
+  }
+
+  // inherited from SpectrumPhy
+  void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  Ptr<NetDevice> GetDevice () const
+  {
+    return 0;
+  }
+  void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  Ptr<MobilityModel> GetMobility () const
+  {
+    return m_mobility;
+  }
+  void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return SpectrumModelIsm2400MhzRes1Mhz;
+  }
+  Ptr<AntennaModel> GetRxAntenna () const
+  {
+    return 0;
+  }
+  void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    uint32_t txId = DynamicCast<CullingTestPhy> (params->txPhy)->GetId ();
+    m_receptions->push_back (CullingTestReception (Simulator::Now ().GetNanoSeconds (),
+                                                   txId, m_id, Integral (*params->psd)));
+  }
+
+private:
+  uint32_t m_id;                                    //!< identifier of the phy
+  Ptr<MobilityModel> m_mobility;                    //!< mobility model of the phy
+  std::vector<CullingTestReception> *m_receptions;  //!< log of the receptions
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Checks that culling receivers with a spatial grid in
+ * MultiModelSpectrumChannel delivers exactly the same signals as
+ * visiting all receivers, with static, moving and relocated receivers.
+ */
+class SpectrumChannelCullingTestCase : public TestCase
+{
+public:
+  SpectrumChannelCullingTestCase ();
+  virtual ~SpectrumChannelCullingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario
+   * \param maxRange the MaxRange attribute of the channel
+   * \return the receptions of all phys
+   */
+  std::vector<CullingTestReception> RunScenario (double maxRange);
+
+  /**
+   * Transmit a signal
+   * \param channel the channel
+   * \param phy the transmitting phy
+   */
+  static void Transmit (Ptr<SpectrumChannel> channel, Ptr<SpectrumPhy> phy);
+
+  std::vector<Vector> m_positions;  //!< initial positions of the phys
+  std::vector<Vector> m_velocities; //!< initial velocities of the phys
+  std::vector<Vector> m_jumps;      //!< positions of the phys after relocation
+};
+
+SpectrumChannelCullingTestCase::SpectrumChannelCullingTestCase ()
+  : TestCase ("Spatial culling of receivers in MultiModelSpectrumChannel")
+{
+}
+
+SpectrumChannelCullingTestCase::~SpectrumChannelCullingTestCase ()
+{
+}
+
+void
+SpectrumChannelCullingTestCase::Transmit (Ptr<SpectrumChannel> channel, Ptr<SpectrumPhy> phy)
+{
+  Ptr<SpectrumValue> psd = Create<SpectrumValue> (SpectrumModelIsm2400MhzRes1Mhz);
+  (*psd) = 1e-9;
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->txPhy = phy;
+  params->psd = psd;
+  params->duration = MicroSeconds (100);
+  channel->StartTx (params);
+}
+
+std::vector<CullingTestReception>
+SpectrumChannelCullingTestCase::RunScenario (double maxRange)
+{
+  std::vector<CullingTestReception> receptions;
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("MaxLossDb", DoubleValue (100));
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  // the default log distance model exceeds 100 dB beyond 59.8 m
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  std::vector<Ptr<CullingTestPhy> > phys;
+  for (uint32_t i = 0; i < m_positions.size (); ++i)
+    {
+      Ptr<CullingTestPhy> phy = CreateObject<CullingTestPhy> (i, &receptions);
+      Ptr<MobilityModel> mobility;
+      if (i % 5 == 0)
+        {
+          Ptr<ConstantVelocityMobilityModel> cv = CreateObject<ConstantVelocityMobilityModel> ();
+          cv->SetPosition (m_positions[i]);
+          cv->SetVelocity (m_velocities[i]);
+          mobility = cv;
+          // stop halfway, the receiver becomes static in its new position
+          Simulator::Schedule (Seconds (1), &ConstantVelocityMobilityModel::SetVelocity, cv, Vector ());
+        }
+      else
+        {
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (m_positions[i]);
+          if (i % 5 == 1)
+            {
+              Simulator::Schedule (Seconds (1), &MobilityModel::SetPosition, mobility, m_jumps[i]);
+            }
+        }
+      phy->SetMobility (mobility);
+      channel->AddRx (phy);
+      phys.push_back (phy);
+    }
+
+  // every phy transmits before and after the course changes
+  for (uint32_t i = 0; i < phys.size (); ++i)
+    {
+      Simulator::Schedule (MilliSeconds (1 + 4 * i), &SpectrumChannelCullingTestCase::Transmit, channel, phys[i]);
+      Simulator::Schedule (MilliSeconds (1001 + 4 * i), &SpectrumChannelCullingTestCase::Transmit, channel, phys[i]);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return receptions;
+}
+
+void
+SpectrumChannelCullingTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> coordinate = CreateObject<UniformRandomVariable> ();
+  coordinate->SetStream (1);
+  coordinate->SetAttribute ("Max", DoubleValue (500));
+  Ptr<UniformRandomVariable> speed = CreateObject<UniformRandomVariable> ();
+  speed->SetStream (2);
+  speed->SetAttribute ("Min", DoubleValue (-80));
+  speed->SetAttribute ("Max", DoubleValue (80));
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      m_positions.push_back (Vector (coordinate->GetValue (), coordinate->GetValue (), 1.5));
+      m_velocities.push_back (Vector (speed->GetValue (), speed->GetValue (), 0));
+      m_jumps.push_back (Vector (coordinate->GetValue (), coordinate->GetValue (), 1.5));
+    }
+
+  std::vector<CullingTestReception> all = RunScenario (0);
+  std::vector<CullingTestReception> culled = RunScenario (60);
+  NS_TEST_ASSERT_MSG_GT (all.size (), 400, "Too few receptions to be meaningful");
+  NS_TEST_ASSERT_MSG_EQ (culled.size (), all.size (), "Different number of receptions");
+  NS_TEST_ASSERT_MSG_EQ ((culled == all), true, "Different receptions with culling");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test suite for the receiver culling of MultiModelSpectrumChannel
+ */
+class SpectrumChannelCullingTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelCullingTestSuite ();
+};
+
+SpectrumChannelCullingTestSuite::SpectrumChannelCullingTestSuite ()
+  : TestSuite ("spectrum-channel-culling", UNIT)
+{
+  AddTestCase (new SpectrumChannelCullingTestCase, TestCase::QUICK);
+}
+
+static SpectrumChannelCullingTestSuite g_spectrumChannelCullingTestSuite;
@@ -45,7 +45,7 @@ main (int argc, char *argv[])
   discoveryMsg.AddToPath (103);
 
   // Set GPS location
-  Vector gpsLoc (37.7749, -122.4194, 50.0); // San Francisco coordinates + altitude
+  Vector gpsLoc (120.5, -42.25, 1.5); // Position in meters
   discoveryMsg.SetGpsLocation (gpsLoc);
   discoveryMsg.SetGpsAvailable (true);
 
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2025
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * BLE Discovery Wire Format Report
+ * Prints the serialized size of discovery and election messages in the
+ * legacy and compact wire formats, for every hop of a message sent with
+ * the given initial TTL. Each hop adds one node to the Path So Far.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/ble_discovery_packet.h"
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BleDiscoveryWireFormatReport");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t initialTtl = 15;  // TTL of the message at its source
+  uint32_t nNodes = 1000;    // Node IDs are drawn from [0, nNodes)
+  double areaSize = 1000.0;  // GPS coordinates are drawn from [0, areaSize) meters
+  uint32_t advertisingPayload = 31; // Legacy BLE advertising payload
+
+  CommandLine cmd;
+  cmd.AddValue ("initialTtl", "TTL of the message at its source", initialTtl);
+  cmd.AddValue ("nNodes", "Number of node IDs in the network", nNodes);
+  cmd.AddValue ("areaSize", "Side of the area of the GPS coordinates in meters", areaSize);
+  cmd.Parse (argc, argv);
+
+  initialTtl = std::min<uint32_t> (initialTtl, BLE_DISCOVERY_MAX_PATH_LENGTH);
+
+  Ptr<UniformRandomVariable> id = CreateObject<UniformRandomVariable> ();
+  id->SetAttribute ("Max", DoubleValue (nNodes));
+  Ptr<UniformRandomVariable> coordinate = CreateObject<UniformRandomVariable> ();
+  coordinate->SetAttribute ("Max", DoubleValue (areaSize));
+
+  ble_election_packet_t election;
+  ble_election_packet_init (&election);
+  ble_discovery_packet_t &packet = election.base;
+  packet.sender_id = id->GetInteger ();
+  packet.ttl = initialTtl;
+  election.election.class_id = 1;
+  election.election.pdsf = 120;
+  election.election.score = 0.87;
+  election.election.hash = ble_election_generate_hash (packet.sender_id);
+
+  std::cout << "Sizes in bytes, '*' marks messages that do not fit in a "
+            << advertisingPayload << "-byte advertising payload" << std::endl;
+  std::cout << "hops\tTTL\tdisc\tcompact\tdisc+GPS\tcompact\telect+GPS\tcompact" << std::endl;
+  for (uint32_t hops = 0; hops <= initialTtl; hops++)
+    {
+      ble_discovery_set_gps (&packet, coordinate->GetValue (),
+                             coordinate->GetValue (), coordinate->GetValue ());
+      packet.gps_available = false;
+      uint32_t sizes[6];
+      sizes[0] = ble_discovery_get_size (&packet);
+      sizes[1] = ble_discovery_get_compact_size (&packet);
+      packet.gps_available = true;
+      sizes[2] = ble_discovery_get_size (&packet);
+      sizes[3] = ble_discovery_get_compact_size (&packet);
+      sizes[4] = ble_election_get_size (&election);
+      sizes[5] = ble_election_get_compact_size (&election);
+
+      std::cout << hops << "\t" << (uint32_t) packet.ttl;
+      for (uint32_t i = 0; i < 6; i++)
+        {
+          std::cout << "\t" << sizes[i] << (sizes[i] > advertisingPayload ? "*" : "");
+        }
+      std::cout << std::endl;
+
+      // Forward the message to the next hop
+      ble_discovery_add_to_path (&packet, id->GetInteger ());
+      ble_discovery_decrement_ttl (&packet);
+    }
+
+  return 0;
+}
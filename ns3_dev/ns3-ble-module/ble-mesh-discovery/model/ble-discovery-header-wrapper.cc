@@ -17,7 +17,8 @@ NS_LOG_COMPONENT_DEFINE ("BleDiscoveryHeaderWrapper");
 NS_OBJECT_ENSURE_REGISTERED (BleDiscoveryHeaderWrapper);
 
 BleDiscoveryHeaderWrapper::BleDiscoveryHeaderWrapper ()
-  : m_isElection (false)
+  : m_isElection (false),
+    m_wireFormat (BLE_WIRE_FORMAT_LEGACY)
 {
   NS_LOG_FUNCTION (this);
   ble_discovery_packet_init (&m_packet);
@@ -65,6 +66,7 @@ BleDiscoveryHeaderWrapper::Print (std::ostream &os) const
     {
       os << ", ClassID=" << m_election.election.class_id;
       os << ", PDSF=" << m_election.election.pdsf;
+      os << ", PDSFProduct=" << m_election.election.pdsf_product;
       os << ", Score=" << m_election.election.score;
     }
 }
@@ -72,6 +74,11 @@ BleDiscoveryHeaderWrapper::Print (std::ostream &os) const
 uint32_t
 BleDiscoveryHeaderWrapper::GetSerializedSize (void) const
 {
+  if (m_wireFormat == BLE_WIRE_FORMAT_COMPACT)
+    {
+      return m_isElection ? ble_election_get_compact_size (&m_election)
+                          : ble_discovery_get_compact_size (&m_packet);
+    }
   if (m_isElection)
     {
       return ble_election_get_size (&m_election);
@@ -82,28 +89,60 @@ BleDiscoveryHeaderWrapper::GetSerializedSize (void) const
     }
 }
 
+/**
+ * Input of the C core reader: the header bytes of a Buffer
+ */
+struct BleDiscoveryHeaderInput
+{
+  Buffer::Iterator *iterator; //!< next byte
+  uint32_t remaining;         //!< bytes left in the buffer
+};
+
+/**
+ * C core writer callback appending to a Buffer
+ * \param context the Buffer::Iterator to write to
+ * \param value the byte
+ */
+static void
+WriteToBuffer (void *context, uint8_t value)
+{
+  static_cast<Buffer::Iterator *> (context)->WriteU8 (value);
+}
+
+/**
+ * C core reader callback consuming a Buffer
+ * \param context the BleDiscoveryHeaderInput to read from
+ * \param value returns the byte
+ * \return false at the end of the buffer
+ */
+static bool
+ReadFromBuffer (void *context, uint8_t *value)
+{
+  BleDiscoveryHeaderInput *input = static_cast<BleDiscoveryHeaderInput *> (context);
+  if (input->remaining == 0)
+    {
+      return false;
+    }
+  input->remaining--;
+  *value = input->iterator->ReadU8 ();
+  return true;
+}
+
 void
 BleDiscoveryHeaderWrapper::Serialize (Buffer::Iterator start) const
 {
   NS_LOG_FUNCTION (this << &start);
 
-  uint32_t size = GetSerializedSize ();
-  uint8_t *buffer = new uint8_t[size];
-
-  uint32_t bytes_written;
+  // The C core writes straight into the NS-3 buffer
+  ble_packet_writer_t writer = { &WriteToBuffer, &start };
   if (m_isElection)
     {
-      bytes_written = ble_election_serialize (&m_election, buffer, size);
+      ble_election_write (&m_election, m_wireFormat, &writer);
     }
   else
     {
-      bytes_written = ble_discovery_serialize (&m_packet, buffer, size);
+      ble_discovery_write (&m_packet, m_wireFormat, &writer);
     }
-
-  // Write to NS-3 buffer
-  start.Write (buffer, bytes_written);
-
-  delete[] buffer;
 }
 
 uint32_t
@@ -111,31 +150,51 @@ BleDiscoveryHeaderWrapper::Deserialize (Buffer::Iterator start)
 {
   NS_LOG_FUNCTION (this << &start);
 
-  // Read first byte to determine message type
+  // Read first byte to determine wire format and message type
   uint8_t msg_type = start.PeekU8 ();
-  m_isElection = (msg_type == BLE_MSG_ELECTION_ANNOUNCEMENT);
+  m_wireFormat = ble_discovery_detect_format (&msg_type, 1);
+  if (m_wireFormat == BLE_WIRE_FORMAT_COMPACT)
+    {
+      m_isElection = (msg_type & BLE_COMPACT_FLAG_ELECTION) != 0;
+    }
+  else
+    {
+      m_isElection = (msg_type == BLE_MSG_ELECTION_ANNOUNCEMENT);
+    }
 
-  // Read into temporary buffer
-  uint32_t available = start.GetRemainingSize ();
-  uint8_t *buffer = new uint8_t[available];
-  start.Read (buffer, available);
+  // The C core reads the header bytes straight from the NS-3 buffer
+  BleDiscoveryHeaderInput input = { &start, start.GetRemainingSize () };
+  ble_packet_reader_t reader = { &ReadFromBuffer, &input };
 
   uint32_t bytes_read;
   if (m_isElection)
     {
-      bytes_read = ble_election_deserialize (&m_election, buffer, available);
+      bytes_read = ble_election_read (&m_election, m_wireFormat, &reader);
       // Sync the base packet reference
       m_packet = m_election.base;
     }
   else
     {
-      bytes_read = ble_discovery_deserialize (&m_packet, buffer, available);
+      bytes_read = ble_discovery_read (&m_packet, m_wireFormat, &reader);
     }
 
-  delete[] buffer;
   return bytes_read;
 }
 
+// ===== Wire Format =====
+
+void
+BleDiscoveryHeaderWrapper::SetWireFormat (ble_wire_format_t format)
+{
+  m_wireFormat = format;
+}
+
+ble_wire_format_t
+BleDiscoveryHeaderWrapper::GetWireFormat (void) const
+{
+  return m_wireFormat;
+}
+
 // ===== Discovery Packet Methods =====
 
 bool
@@ -301,6 +360,19 @@ BleDiscoveryHeaderWrapper::GetPdsf (void) const
   return m_isElection ? m_election.election.pdsf : 0;
 }
 
+void
+BleDiscoveryHeaderWrapper::AppendPdsf (uint32_t directCount)
+{
+  if (!m_isElection) SetAsElectionMessage ();
+  ble_election_append_pdsf (&m_election.election, directCount);
+}
+
+uint32_t
+BleDiscoveryHeaderWrapper::GetPdsfProduct (void) const
+{
+  return m_isElection ? m_election.election.pdsf_product : 0;
+}
+
 void
 BleDiscoveryHeaderWrapper::SetScore (double score)
 {
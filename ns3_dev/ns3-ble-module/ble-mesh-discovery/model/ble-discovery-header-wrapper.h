@@ -197,6 +197,23 @@ public:
    */
   uint32_t GetPdsf (void) const;
 
+  /**
+   * \brief Append a forwarding node's direct count to the PDSF, in O(1)
+   *
+   * Updates the PDSF and the PDSF product, saturating at UINT32_MAX.
+   * Only the compact wire format carries the product; after a legacy
+   * message it is 0 and the PDSF does not grow.
+   *
+   * \param directCount direct connection count of the forwarding node
+   */
+  void AppendPdsf (uint32_t directCount);
+
+  /**
+   * \brief Get the PDSF product (product of the direct counts so far)
+   * \return the PDSF product
+   */
+  uint32_t GetPdsfProduct (void) const;
+
   /**
    * \brief Set score
    * \param score the score
@@ -221,6 +238,23 @@ public:
    */
   uint32_t GetHash (void) const;
 
+  // ===== Wire format =====
+
+  /**
+   * \brief Select the wire format used by Serialize
+   *
+   * Deserialize detects the format of the received bytes and selects it.
+   *
+   * \param format the wire format
+   */
+  void SetWireFormat (ble_wire_format_t format);
+
+  /**
+   * \brief Get the wire format used by Serialize
+   * \return the wire format
+   */
+  ble_wire_format_t GetWireFormat (void) const;
+
   // ===== Direct access to C structures (for advanced use) =====
 
   /**
@@ -237,6 +271,7 @@ public:
 
 private:
   bool m_isElection;                  //!< Track if this is election message
+  ble_wire_format_t m_wireFormat;     //!< Encoding used by Serialize
   ble_discovery_packet_t m_packet;    //!< C discovery packet structure
   ble_election_packet_t m_election;   //!< C election packet structure
 };
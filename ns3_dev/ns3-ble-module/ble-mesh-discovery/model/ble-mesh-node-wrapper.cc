@@ -10,6 +10,8 @@
 #include "ble-mesh-node-wrapper.h"
 #include "ns3/log.h"
 #include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -29,6 +31,13 @@ BleMeshNodeWrapper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&BleMeshNodeWrapper::m_gpsEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("WireFormat",
+                   "Wire format of the packets transmitted by this node",
+                   EnumValue (BLE_WIRE_FORMAT_LEGACY),
+                   MakeEnumAccessor (&BleMeshNodeWrapper::SetWireFormat,
+                                     &BleMeshNodeWrapper::GetWireFormat),
+                   MakeEnumChecker (BLE_WIRE_FORMAT_LEGACY, "Legacy",
+                                    BLE_WIRE_FORMAT_COMPACT, "Compact"))
     .AddTraceSource ("StateChange",
                      "Trace fired when node state changes",
                      MakeTraceSourceAccessor (&BleMeshNodeWrapper::m_stateChangeTrace),
@@ -54,7 +63,11 @@ void
 BleMeshNodeWrapper::Initialize (uint32_t nodeId)
 {
   NS_LOG_FUNCTION (this << nodeId);
+  // Keep the configured wire format
+  ble_wire_format_t format = ble_mesh_node_get_wire_format (&m_node);
   ble_mesh_node_init (&m_node, nodeId);
+  ble_mesh_node_set_wire_format (&m_node, format);
+  m_pendingObservations.clear ();
 }
 
 // ===== GPS Management =====
@@ -200,6 +213,59 @@ BleMeshNodeWrapper::UpdateNeighborGps (uint32_t neighborId, Vector gps)
   return ble_mesh_node_update_neighbor_gps (&m_node, neighborId, &gps_c);
 }
 
+void
+BleMeshNodeWrapper::QueueNeighborObservation (uint32_t neighborId, int8_t rssi, uint8_t hopCount)
+{
+  ble_neighbor_observation_t observation;
+  observation.node_id = neighborId;
+  observation.gps.x = 0.0;
+  observation.gps.y = 0.0;
+  observation.gps.z = 0.0;
+  observation.rssi = rssi;
+  observation.hop_count = hopCount;
+  observation.gps_valid = false;
+  m_pendingObservations.push_back (observation);
+}
+
+void
+BleMeshNodeWrapper::QueueNeighborObservation (uint32_t neighborId, int8_t rssi, uint8_t hopCount,
+                                              Vector gps)
+{
+  QueueNeighborObservation (neighborId, rssi, hopCount);
+  ble_neighbor_observation_t &observation = m_pendingObservations.back ();
+  observation.gps.x = gps.x;
+  observation.gps.y = gps.y;
+  observation.gps.z = gps.z;
+  observation.gps_valid = true;
+}
+
+uint16_t
+BleMeshNodeWrapper::FlushNeighborObservations (void)
+{
+  NS_LOG_FUNCTION (this << m_pendingObservations.size ());
+
+  // The C API takes at most 65535 observations per call
+  uint16_t stored = 0;
+  std::size_t offset = 0;
+  while (offset < m_pendingObservations.size ())
+    {
+      uint16_t chunk = static_cast<uint16_t> (std::min<std::size_t> (m_pendingObservations.size () - offset,
+                                                                     UINT16_MAX));
+      stored += ble_mesh_node_add_neighbors (&m_node, &m_pendingObservations[offset], chunk);
+      offset += chunk;
+    }
+
+  // Keep the capacity for the next slot
+  m_pendingObservations.clear ();
+  return stored;
+}
+
+uint32_t
+BleMeshNodeWrapper::GetPendingObservationCount (void) const
+{
+  return m_pendingObservations.size ();
+}
+
 uint16_t
 BleMeshNodeWrapper::GetNeighborCount (void) const
 {
@@ -212,6 +278,12 @@ BleMeshNodeWrapper::GetDirectNeighborCount (void) const
   return ble_mesh_node_count_direct_neighbors (&m_node);
 }
 
+uint16_t
+BleMeshNodeWrapper::GetGpsNeighborCount (void) const
+{
+  return ble_mesh_node_count_gps_neighbors (&m_node);
+}
+
 int8_t
 BleMeshNodeWrapper::GetAverageRssi (void) const
 {
@@ -372,4 +444,34 @@ BleMeshNodeWrapper::GetNodeId (void) const
   return m_node.node_id;
 }
 
+// ===== Encoding =====
+
+void
+BleMeshNodeWrapper::SetWireFormat (ble_wire_format_t format)
+{
+  ble_mesh_node_set_wire_format (&m_node, format);
+}
+
+ble_wire_format_t
+BleMeshNodeWrapper::GetWireFormat (void) const
+{
+  return ble_mesh_node_get_wire_format (&m_node);
+}
+
+bool
+BleMeshNodeWrapper::ConfigureDuplicateFilter (uint32_t expectedMessages,
+                                              double falsePositiveRate,
+                                              uint32_t maxAgeCycles)
+{
+  NS_LOG_FUNCTION (this << expectedMessages << falsePositiveRate << maxAgeCycles);
+  return ble_mesh_node_configure_dedup (&m_node, expectedMessages,
+                                        falsePositiveRate, maxAgeCycles);
+}
+
+bool
+BleMeshNodeWrapper::IsDuplicateMessage (uint32_t senderId, uint32_t sequence)
+{
+  return ble_mesh_node_is_duplicate (&m_node, senderId, sequence);
+}
+
 } // namespace ns3
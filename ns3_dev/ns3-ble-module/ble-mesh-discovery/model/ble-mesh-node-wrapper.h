@@ -184,6 +184,40 @@ public:
    */
   bool UpdateNeighborGps (uint32_t neighborId, Vector gps);
 
+  /**
+   * \brief Record a reception, to be applied at the next flush
+   *
+   * Lets the receive path collect a whole slot and apply it with
+   * FlushNeighborObservations() in one pass.
+   *
+   * \param neighborId Neighbor's node ID
+   * \param rssi RSSI value (dBm)
+   * \param hopCount Hop count to neighbor
+   */
+  void QueueNeighborObservation (uint32_t neighborId, int8_t rssi, uint8_t hopCount);
+
+  /**
+   * \brief Record a reception carrying a GPS location, to be applied at the next flush
+   * \param neighborId Neighbor's node ID
+   * \param rssi RSSI value (dBm)
+   * \param hopCount Hop count to neighbor
+   * \param gps Neighbor's GPS location
+   */
+  void QueueNeighborObservation (uint32_t neighborId, int8_t rssi, uint8_t hopCount,
+                                 Vector gps);
+
+  /**
+   * \brief Apply the queued receptions to the neighbor table
+   * \return Number of receptions stored (the rest found the table full)
+   */
+  uint16_t FlushNeighborObservations (void);
+
+  /**
+   * \brief Get number of receptions waiting for the next flush
+   * \return Queued reception count
+   */
+  uint32_t GetPendingObservationCount (void) const;
+
   /**
    * \brief Get number of neighbors
    * \return Neighbor count
@@ -196,6 +230,12 @@ public:
    */
   uint16_t GetDirectNeighborCount (void) const;
 
+  /**
+   * \brief Get number of neighbors with a valid GPS location
+   * \return GPS neighbor count
+   */
+  uint16_t GetGpsNeighborCount (void) const;
+
   /**
    * \brief Get average RSSI of all neighbors
    * \return Average RSSI in dBm
@@ -350,6 +390,44 @@ public:
    */
   uint32_t GetNodeId (void) const;
 
+  // ===== Encoding =====
+
+  /**
+   * \brief Select the wire format of the packets this node transmits
+   * \param format Wire format
+   */
+  void SetWireFormat (ble_wire_format_t format);
+
+  /**
+   * \brief Get the wire format of the packets this node transmits
+   * \return Wire format
+   */
+  ble_wire_format_t GetWireFormat (void) const;
+
+  // ===== Duplicate Suppression =====
+
+  /**
+   * \brief Resize the cache of seen messages (forgets its contents)
+   *
+   * Call after Initialize(), which resets the cache to its defaults.
+   *
+   * \param expectedMessages Distinct messages expected per cache generation
+   * \param falsePositiveRate Target false-positive rate, in (0, 1)
+   * \param maxAgeCycles Discovery cycles per cache generation
+   * \return false if a parameter is invalid
+   */
+  bool ConfigureDuplicateFilter (uint32_t expectedMessages,
+                                 double falsePositiveRate,
+                                 uint32_t maxAgeCycles);
+
+  /**
+   * \brief Check if a message was already seen, and record it
+   * \param senderId Originator of the message
+   * \param sequence Sequence number of the message at its originator
+   * \return true if the message is a duplicate (or a false positive)
+   */
+  bool IsDuplicateMessage (uint32_t senderId, uint32_t sequence);
+
   // ===== Direct C Access =====
 
   /**
@@ -369,6 +447,7 @@ public:
 
 private:
   ble_mesh_node_t m_node;  //!< C node structure
+  std::vector<ble_neighbor_observation_t> m_pendingObservations; //!< Receptions since the last flush
 
   /**
    * \brief State change traced callback
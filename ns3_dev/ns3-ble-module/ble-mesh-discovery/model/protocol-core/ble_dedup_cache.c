@@ -0,0 +1,190 @@
+/**
+ * @file ble_dedup_cache.c
+ * @brief Pure C duplicate-suppression cache for flooded discovery messages
+ */
+
+#include "ble_dedup_cache.h"
+#include <string.h>
+#include <math.h>
+
+/* ===== Helper Functions ===== */
+
+/**
+ * @brief Mix a (sender, sequence) key into 64 well-distributed bits (splitmix64)
+ */
+static inline uint64_t dedup_hash(uint32_t sender_id, uint32_t sequence)
+{
+    uint64_t x = ((uint64_t)sender_id << 32) | sequence;
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Bit positions of a key, by double hashing
+ * @param positions Output, cache->num_hashes entries
+ */
+static inline void dedup_positions(const ble_dedup_cache_t *cache,
+                                   uint32_t sender_id,
+                                   uint32_t sequence,
+                                   uint16_t *positions)
+{
+    uint64_t hash = dedup_hash(sender_id, sequence);
+    uint32_t h1 = (uint32_t)hash;
+    uint32_t h2 = (uint32_t)(hash >> 32) | 1; // odd, so probes differ
+    for (uint8_t i = 0; i < cache->num_hashes; i++) {
+        positions[i] = (uint16_t)((h1 + i * h2) % cache->num_bits);
+    }
+}
+
+/**
+ * @brief Check if all bits of a key are set in one generation
+ */
+static inline bool dedup_generation_contains(const uint8_t *bits,
+                                             const uint16_t *positions,
+                                             uint8_t num_hashes)
+{
+    for (uint8_t i = 0; i < num_hashes; i++) {
+        if (!(bits[positions[i] >> 3] & (1u << (positions[i] & 7)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Fraction of set bits in one generation
+ */
+static double dedup_fill_ratio(const ble_dedup_cache_t *cache, const uint8_t *bits)
+{
+    uint32_t set = 0;
+    for (uint16_t i = 0; i < cache->num_bits; i++) {
+        if (bits[i >> 3] & (1u << (i & 7))) {
+            set++;
+        }
+    }
+    return (double)set / cache->num_bits;
+}
+
+/* ===== Initialization ===== */
+
+bool ble_dedup_init(ble_dedup_cache_t *cache,
+                    uint32_t expected_messages,
+                    double false_positive_rate,
+                    uint32_t max_age_cycles)
+{
+    if (!cache) return false;
+    if (expected_messages == 0 || max_age_cycles == 0) return false;
+    if (!(false_positive_rate > 0.0 && false_positive_rate < 1.0)) return false;
+
+    // Optimal Bloom filter: m = -n ln(p) / ln(2)^2, k = m/n ln(2)
+    double ln2 = log(2.0);
+    double bits = -(double)expected_messages * log(false_positive_rate) / (ln2 * ln2);
+    if (bits > BLE_DEDUP_MAX_BITS) bits = BLE_DEDUP_MAX_BITS;
+    if (bits < 8) bits = 8;
+    uint16_t num_bits = (uint16_t)ceil(bits);
+
+    double hashes = (double)num_bits / expected_messages * ln2;
+    uint8_t num_hashes = (uint8_t)(hashes + 0.5);
+    if (num_hashes < 1) num_hashes = 1;
+    if (num_hashes > BLE_DEDUP_MAX_HASHES) num_hashes = BLE_DEDUP_MAX_HASHES;
+
+    cache->num_bits = num_bits;
+    cache->num_hashes = num_hashes;
+    cache->max_age_cycles = max_age_cycles;
+    ble_dedup_clear(cache, 0);
+    return true;
+}
+
+void ble_dedup_clear(ble_dedup_cache_t *cache, uint32_t current_cycle)
+{
+    if (!cache) return;
+
+    memset(cache->bits, 0, sizeof(cache->bits));
+    cache->current = 0;
+    cache->generation_start = current_cycle;
+    cache->inserted = 0;
+}
+
+/* ===== Aging ===== */
+
+void ble_dedup_advance_cycle(ble_dedup_cache_t *cache, uint32_t current_cycle)
+{
+    if (!cache) return;
+
+    uint32_t age = current_cycle - cache->generation_start;
+    if (age < cache->max_age_cycles) return;
+
+    if (age >= 2 * cache->max_age_cycles) {
+        // Both generations expired
+        ble_dedup_clear(cache, current_cycle);
+        return;
+    }
+
+    // The current generation becomes the previous one
+    cache->current ^= 1;
+    memset(cache->bits[cache->current], 0, sizeof(cache->bits[0]));
+    cache->generation_start += cache->max_age_cycles;
+    cache->inserted = 0;
+}
+
+/* ===== Lookups ===== */
+
+bool ble_dedup_contains(const ble_dedup_cache_t *cache,
+                        uint32_t sender_id,
+                        uint32_t sequence)
+{
+    if (!cache || cache->num_bits == 0) return false;
+
+    uint16_t positions[BLE_DEDUP_MAX_HASHES];
+    dedup_positions(cache, sender_id, sequence, positions);
+    return dedup_generation_contains(cache->bits[0], positions, cache->num_hashes) ||
+           dedup_generation_contains(cache->bits[1], positions, cache->num_hashes);
+}
+
+void ble_dedup_insert(ble_dedup_cache_t *cache, uint32_t sender_id, uint32_t sequence)
+{
+    if (!cache || cache->num_bits == 0) return;
+
+    uint16_t positions[BLE_DEDUP_MAX_HASHES];
+    dedup_positions(cache, sender_id, sequence, positions);
+    uint8_t *bits = cache->bits[cache->current];
+    for (uint8_t i = 0; i < cache->num_hashes; i++) {
+        bits[positions[i] >> 3] |= (uint8_t)(1u << (positions[i] & 7));
+    }
+    cache->inserted++;
+}
+
+bool ble_dedup_check_and_insert(ble_dedup_cache_t *cache,
+                                uint32_t sender_id,
+                                uint32_t sequence)
+{
+    if (!cache || cache->num_bits == 0) return false;
+
+    uint16_t positions[BLE_DEDUP_MAX_HASHES];
+    dedup_positions(cache, sender_id, sequence, positions);
+    uint8_t *bits = cache->bits[cache->current];
+    if (dedup_generation_contains(bits, positions, cache->num_hashes)) {
+        return true;
+    }
+    bool seen = dedup_generation_contains(cache->bits[cache->current ^ 1],
+                                          positions, cache->num_hashes);
+
+    // Also refresh messages of the previous generation, so they survive the next rotation
+    for (uint8_t i = 0; i < cache->num_hashes; i++) {
+        bits[positions[i] >> 3] |= (uint8_t)(1u << (positions[i] & 7));
+    }
+    cache->inserted++;
+    return seen;
+}
+
+double ble_dedup_estimated_fp_rate(const ble_dedup_cache_t *cache)
+{
+    if (!cache || cache->num_bits == 0) return 0.0;
+
+    // A lookup matches if either generation has all probed bits set
+    double current = pow(dedup_fill_ratio(cache, cache->bits[0]), cache->num_hashes);
+    double previous = pow(dedup_fill_ratio(cache, cache->bits[1]), cache->num_hashes);
+    return 1.0 - (1.0 - current) * (1.0 - previous);
+}
@@ -0,0 +1,131 @@
+/**
+ * @file ble_dedup_cache.h
+ * @brief Pure C duplicate-suppression cache for flooded discovery messages
+ *
+ * A rotating Bloom filter keyed on (sender_id, sequence). Two generations of
+ * bits are kept; lookups check both, insertions go to the current one, and
+ * the older generation is dropped every max_age_cycles discovery cycles.
+ * A message is therefore remembered for at least max_age_cycles and at most
+ * twice that.
+ *
+ * The memory is fixed (no malloc), so the cache can be embedded in a node
+ * structure. Can be compiled without NS-3 or any C++ dependencies.
+ */
+
+#ifndef BLE_DEDUP_CACHE_H
+#define BLE_DEDUP_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ===== Constants ===== */
+
+#define BLE_DEDUP_MAX_BITS 4096             /**< Bits per generation (memory bound) */
+#define BLE_DEDUP_MAX_HASHES 8              /**< Maximum bit probes per key */
+#define BLE_DEDUP_DEFAULT_EXPECTED 150      /**< Default messages per generation */
+#define BLE_DEDUP_DEFAULT_FP_RATE 0.01      /**< Default false-positive rate */
+#define BLE_DEDUP_DEFAULT_MAX_AGE 4         /**< Default generation length in cycles */
+
+/* ===== Cache Structure ===== */
+
+/**
+ * @brief Rotating Bloom filter of seen messages
+ */
+typedef struct {
+    uint8_t bits[2][BLE_DEDUP_MAX_BITS / 8]; /**< Current and previous generation */
+    uint8_t current;              /**< Index of the current generation */
+    uint8_t num_hashes;           /**< Bit probes per key */
+    uint16_t num_bits;            /**< Bits used per generation */
+    uint32_t max_age_cycles;      /**< Cycles per generation */
+    uint32_t generation_start;    /**< Cycle when the current generation started */
+    uint32_t inserted;            /**< Keys inserted in the current generation */
+} ble_dedup_cache_t;
+
+/* ===== Function Prototypes ===== */
+
+/**
+ * @brief Initialize a cache sized for a target false-positive rate
+ *
+ * The number of bits is -n ln(p) / ln(2)^2 for n expected messages per
+ * generation and false-positive rate p, limited to BLE_DEDUP_MAX_BITS.
+ * When the limit applies, the actual rate is higher than requested.
+ *
+ * @param cache Pointer to cache structure
+ * @param expected_messages Distinct messages expected per generation (> 0)
+ * @param false_positive_rate Target false-positive rate, in (0.0, 1.0)
+ * @param max_age_cycles Discovery cycles per generation (> 0)
+ * @return false if a parameter is invalid (the cache is left unchanged)
+ */
+bool ble_dedup_init(ble_dedup_cache_t *cache,
+                    uint32_t expected_messages,
+                    double false_positive_rate,
+                    uint32_t max_age_cycles);
+
+/**
+ * @brief Forget all messages, keeping the configuration
+ * @param cache Pointer to cache structure
+ * @param current_cycle Cycle the new generation starts at
+ */
+void ble_dedup_clear(ble_dedup_cache_t *cache, uint32_t current_cycle);
+
+/**
+ * @brief Age the cache to the given discovery cycle
+ *
+ * Starts a new generation when the current one is max_age_cycles old. If
+ * two or more generations have passed, the cache is emptied.
+ *
+ * @param cache Pointer to cache structure
+ * @param current_cycle Current discovery cycle
+ */
+void ble_dedup_advance_cycle(ble_dedup_cache_t *cache, uint32_t current_cycle);
+
+/**
+ * @brief Check if a message was (probably) seen
+ * @param cache Pointer to cache structure
+ * @param sender_id Originator of the message
+ * @param sequence Sequence number of the message at its originator
+ * @return true if seen, or a false positive; false if certainly not seen
+ */
+bool ble_dedup_contains(const ble_dedup_cache_t *cache,
+                        uint32_t sender_id,
+                        uint32_t sequence);
+
+/**
+ * @brief Record a message
+ * @param cache Pointer to cache structure
+ * @param sender_id Originator of the message
+ * @param sequence Sequence number of the message at its originator
+ */
+void ble_dedup_insert(ble_dedup_cache_t *cache, uint32_t sender_id, uint32_t sequence);
+
+/**
+ * @brief Check if a message was seen, and record it
+ *
+ * A duplicate found only in the previous generation is recorded again in the
+ * current one, so it is remembered as long as its copies keep arriving.
+ *
+ * @param cache Pointer to cache structure
+ * @param sender_id Originator of the message
+ * @param sequence Sequence number of the message at its originator
+ * @return true if the message is a duplicate (or a false positive)
+ */
+bool ble_dedup_check_and_insert(ble_dedup_cache_t *cache,
+                                uint32_t sender_id,
+                                uint32_t sequence);
+
+/**
+ * @brief Estimate the false-positive rate of the current contents
+ * @param cache Pointer to cache structure
+ * @return Probability that an unseen message is reported as seen
+ */
+double ble_dedup_estimated_fp_rate(const ble_dedup_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_DEDUP_CACHE_H */
@@ -11,93 +11,237 @@
 /* ===== Helper Functions for Serialization ===== */
 
 /**
- * @brief Write uint8_t to buffer
+ * @brief Reader state counting the consumed bytes
  */
-static inline void write_u8(uint8_t **buf, uint8_t value)
+typedef struct {
+    const ble_packet_reader_t *reader; /**< Source of the bytes */
+    uint32_t count;                    /**< Bytes consumed so far */
+} read_state_t;
+
+/**
+ * @brief Write uint8_t to writer
+ */
+static inline void write_u8(const ble_packet_writer_t *w, uint8_t value)
 {
-    **buf = value;
-    (*buf)++;
+    w->write_u8(w->context, value);
 }
 
 /**
- * @brief Write uint16_t to buffer (big-endian/network byte order)
+ * @brief Write uint16_t to writer (big-endian/network byte order)
  */
-static inline void write_u16(uint8_t **buf, uint16_t value)
+static inline void write_u16(const ble_packet_writer_t *w, uint16_t value)
 {
-    **buf = (value >> 8) & 0xFF;
-    (*buf)++;
-    **buf = value & 0xFF;
-    (*buf)++;
+    write_u8(w, (value >> 8) & 0xFF);
+    write_u8(w, value & 0xFF);
 }
 
 /**
- * @brief Write uint32_t to buffer (big-endian/network byte order)
+ * @brief Write uint32_t to writer (big-endian/network byte order)
  */
-static inline void write_u32(uint8_t **buf, uint32_t value)
+static inline void write_u32(const ble_packet_writer_t *w, uint32_t value)
 {
-    **buf = (value >> 24) & 0xFF;
-    (*buf)++;
-    **buf = (value >> 16) & 0xFF;
-    (*buf)++;
-    **buf = (value >> 8) & 0xFF;
-    (*buf)++;
-    **buf = value & 0xFF;
-    (*buf)++;
+    write_u8(w, (value >> 24) & 0xFF);
+    write_u8(w, (value >> 16) & 0xFF);
+    write_u8(w, (value >> 8) & 0xFF);
+    write_u8(w, value & 0xFF);
 }
 
 /**
- * @brief Write double to buffer (IEEE 754)
+ * @brief Write double to writer (IEEE 754)
  */
-static inline void write_double(uint8_t **buf, double value)
+static inline void write_double(const ble_packet_writer_t *w, double value)
 {
     uint64_t bits;
     memcpy(&bits, &value, sizeof(double));
-    write_u32(buf, (bits >> 32) & 0xFFFFFFFF);
-    write_u32(buf, bits & 0xFFFFFFFF);
+    write_u32(w, (bits >> 32) & 0xFFFFFFFF);
+    write_u32(w, bits & 0xFFFFFFFF);
+}
+
+/**
+ * @brief Read uint8_t from reader
+ * @return false at the end of the input
+ */
+static inline bool read_u8(read_state_t *r, uint8_t *value)
+{
+    if (!r->reader->read_u8(r->reader->context, value)) return false;
+    r->count++;
+    return true;
+}
+
+/**
+ * @brief Read uint16_t from reader (big-endian/network byte order)
+ */
+static inline bool read_u16(read_state_t *r, uint16_t *value)
+{
+    uint8_t b0, b1;
+    if (!read_u8(r, &b0) || !read_u8(r, &b1)) return false;
+    *value = ((uint16_t)b0 << 8) | b1;
+    return true;
+}
+
+/**
+ * @brief Read uint32_t from reader (big-endian/network byte order)
+ */
+static inline bool read_u32(read_state_t *r, uint32_t *value)
+{
+    uint16_t high, low;
+    if (!read_u16(r, &high) || !read_u16(r, &low)) return false;
+    *value = ((uint32_t)high << 16) | low;
+    return true;
+}
+
+/**
+ * @brief Read double from reader (IEEE 754)
+ */
+static inline bool read_double(read_state_t *r, double *value)
+{
+    uint32_t high, low;
+    if (!read_u32(r, &high) || !read_u32(r, &low)) return false;
+    uint64_t bits = ((uint64_t)high << 32) | low;
+    memcpy(value, &bits, sizeof(double));
+    return true;
+}
+
+/**
+ * @brief Writer callback appending to a flat buffer (size checked by the caller)
+ */
+static void buffer_write_u8(void *context, uint8_t value)
+{
+    uint8_t **ptr = (uint8_t **)context;
+    **ptr = value;
+    (*ptr)++;
+}
+
+/**
+ * @brief Bounds of a flat input buffer
+ */
+typedef struct {
+    const uint8_t *ptr; /**< Next byte */
+    const uint8_t *end; /**< End of the buffer */
+} buffer_input_t;
+
+/**
+ * @brief Reader callback consuming a flat buffer
+ */
+static bool buffer_read_u8(void *context, uint8_t *value)
+{
+    buffer_input_t *input = (buffer_input_t *)context;
+    if (input->ptr >= input->end) return false;
+    *value = *input->ptr++;
+    return true;
+}
+
+/* ===== Helper Functions for the Compact Format ===== */
+
+/**
+ * @brief Number of bytes of an unsigned LEB128 varint
+ */
+static inline uint32_t varint_size(uint32_t value)
+{
+    uint32_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+/**
+ * @brief Write unsigned LEB128 varint to writer (7 bits per byte, low first)
+ */
+static inline void write_varint(const ble_packet_writer_t *w, uint32_t value)
+{
+    while (value >= 0x80) {
+        write_u8(w, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    write_u8(w, (uint8_t)value);
+}
+
+/**
+ * @brief Read unsigned LEB128 varint from reader
+ * @return false if the varint is truncated or longer than 32 bits, value is
+ *         then set to 0
+ */
+static inline bool read_varint(read_state_t *r, uint32_t *value)
+{
+    uint32_t result = 0;
+    *value = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+        uint8_t byte;
+        if (!read_u8(r, &byte)) return false;
+        if (shift == 28 && (byte & 0xF0) != 0) return false;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Map a signed value to unsigned so small magnitudes stay small
+ */
+static inline uint32_t zigzag_encode(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
 }
 
 /**
- * @brief Read uint8_t from buffer
+ * @brief Inverse of zigzag_encode()
  */
-static inline uint8_t read_u8(const uint8_t **buf)
+static inline int32_t zigzag_decode(uint32_t value)
 {
-    uint8_t value = **buf;
-    (*buf)++;
-    return value;
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
 }
 
 /**
- * @brief Read uint16_t from buffer (big-endian/network byte order)
+ * @brief Difference between consecutive path IDs, modulo 2^32
  */
-static inline uint16_t read_u16(const uint8_t **buf)
+static inline uint32_t path_delta(uint32_t prev, uint32_t id)
 {
-    uint16_t value = ((uint16_t)(*buf)[0] << 8) | (*buf)[1];
-    (*buf) += 2;
-    return value;
+    uint32_t diff = id - prev;
+    // Two's complement reinterpretation, without relying on implementation-defined casts
+    int32_t delta = (diff <= 0x7FFFFFFFu) ? (int32_t)diff : -(int32_t)(~diff) - 1;
+    return zigzag_encode(delta);
 }
 
 /**
- * @brief Read uint32_t from buffer (big-endian/network byte order)
+ * @brief Round a coordinate to a saturated fixed-point value
  */
-static inline uint32_t read_u32(const uint8_t **buf)
+static inline int32_t quantize_gps(double value)
 {
-    uint32_t value = ((uint32_t)(*buf)[0] << 24) |
-                     ((uint32_t)(*buf)[1] << 16) |
-                     ((uint32_t)(*buf)[2] << 8) |
-                     (*buf)[3];
-    (*buf) += 4;
-    return value;
+    double scaled = value * BLE_COMPACT_GPS_SCALE;
+    if (scaled != scaled) return 0; // NaN
+    if (scaled >= 2147483647.0) return INT32_MAX;
+    if (scaled <= -2147483648.0) return INT32_MIN;
+    return (int32_t)(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5);
 }
 
 /**
- * @brief Read double from buffer (IEEE 754)
+ * @brief Round a score to fixed-point, clamped to [0.0, 1.0]
  */
-static inline double read_double(const uint8_t **buf)
+static inline uint16_t quantize_score(double score)
 {
-    uint64_t bits = ((uint64_t)read_u32(buf) << 32) | read_u32(buf);
-    double value;
-    memcpy(&value, &bits, sizeof(double));
-    return value;
+    if (!(score > 0.0)) return 0; // also NaN
+    if (score >= 1.0) return 0xFFFF;
+    return (uint16_t)(score * BLE_COMPACT_SCORE_SCALE + 0.5);
+}
+
+/**
+ * @brief Header byte of a compact packet
+ */
+static inline uint8_t compact_header(const ble_discovery_packet_t *packet)
+{
+    uint8_t header = BLE_COMPACT_MARKER | (BLE_COMPACT_VERSION << 4);
+    if (packet->message_type == BLE_MSG_ELECTION_ANNOUNCEMENT) {
+        header |= BLE_COMPACT_FLAG_ELECTION;
+    }
+    if (packet->gps_available) {
+        header |= BLE_COMPACT_FLAG_GPS;
+    }
+    return header;
 }
 
 /* ===== Packet Initialization ===== */
@@ -125,6 +269,7 @@ void ble_election_packet_init(ble_election_packet_t *packet)
 
     packet->election.class_id = 0;
     packet->election.pdsf = 0;
+    packet->election.pdsf_product = 1;
     packet->election.score = 0.0;
     packet->election.hash = 0;
 }
@@ -212,81 +357,312 @@ uint32_t ble_election_get_size(const ble_election_packet_t *packet)
     return size;
 }
 
-/* ===== Serialization ===== */
+/* ===== Stream Serialization ===== */
 
-uint32_t ble_discovery_serialize(const ble_discovery_packet_t *packet,
-                                   uint8_t *buffer,
-                                   uint32_t buffer_size)
+/**
+ * @brief Write the discovery fields in the legacy format
+ */
+static void write_discovery_legacy(const ble_discovery_packet_t *packet,
+                                   const ble_packet_writer_t *w)
 {
-    if (!packet || !buffer) return 0;
-
-    uint32_t required_size = ble_discovery_get_size(packet);
-    if (buffer_size < required_size) return 0;
-
-    uint8_t *ptr = buffer;
-
     // Write message type
-    write_u8(&ptr, (uint8_t)packet->message_type);
+    write_u8(w, (uint8_t)packet->message_type);
 
     // Write sender ID
-    write_u32(&ptr, packet->sender_id);
+    write_u32(w, packet->sender_id);
 
     // Write TTL
-    write_u8(&ptr, packet->ttl);
+    write_u8(w, packet->ttl);
 
     // Write Path So Far
-    write_u16(&ptr, packet->path_length);
+    write_u16(w, packet->path_length);
     for (uint16_t i = 0; i < packet->path_length; i++) {
-        write_u32(&ptr, packet->path[i]);
+        write_u32(w, packet->path[i]);
     }
 
     // Write GPS availability
-    write_u8(&ptr, packet->gps_available ? 1 : 0);
+    write_u8(w, packet->gps_available ? 1 : 0);
     if (packet->gps_available) {
-        write_double(&ptr, packet->gps_location.x);
-        write_double(&ptr, packet->gps_location.y);
-        write_double(&ptr, packet->gps_location.z);
+        write_double(w, packet->gps_location.x);
+        write_double(w, packet->gps_location.y);
+        write_double(w, packet->gps_location.z);
     }
-
-    return (uint32_t)(ptr - buffer);
 }
 
-uint32_t ble_discovery_deserialize(ble_discovery_packet_t *packet,
-                                     const uint8_t *buffer,
-                                     uint32_t buffer_size)
+/**
+ * @brief Write the discovery fields in the compact format
+ * @param header Header byte, carrying the flags
+ */
+static void write_discovery_compact(const ble_discovery_packet_t *packet,
+                                    uint8_t header,
+                                    const ble_packet_writer_t *w)
 {
-    if (!packet || !buffer || buffer_size < 6) return 0;
+    // Write header: marker, version, election and GPS flags
+    write_u8(w, header);
 
-    const uint8_t *ptr = buffer;
+    // Write TTL and sender ID
+    write_u8(w, packet->ttl);
+    write_varint(w, packet->sender_id);
 
-    // Read message type
-    packet->message_type = (ble_message_type_t)read_u8(&ptr);
+    // Write Path So Far, each ID relative to the previous one
+    write_varint(w, packet->path_length);
+    uint32_t prev = 0;
+    for (uint16_t i = 0; i < packet->path_length; i++) {
+        write_varint(w, path_delta(prev, packet->path[i]));
+        prev = packet->path[i];
+    }
 
-    // Read sender ID
-    packet->sender_id = read_u32(&ptr);
+    // Write GPS coordinates
+    if (packet->gps_available) {
+        write_varint(w, zigzag_encode(quantize_gps(packet->gps_location.x)));
+        write_varint(w, zigzag_encode(quantize_gps(packet->gps_location.y)));
+        write_varint(w, zigzag_encode(quantize_gps(packet->gps_location.z)));
+    }
+}
+
+/**
+ * @brief Read the discovery fields in the legacy format
+ * @param first First byte of the packet, already consumed
+ */
+static bool read_discovery_legacy(ble_discovery_packet_t *packet,
+                                  uint8_t first,
+                                  read_state_t *r)
+{
+    // Message type
+    packet->message_type = (ble_message_type_t)first;
 
-    // Read TTL
-    packet->ttl = read_u8(&ptr);
+    // Read sender ID and TTL
+    if (!read_u32(r, &packet->sender_id)) return false;
+    if (!read_u8(r, &packet->ttl)) return false;
 
     // Read Path So Far
-    packet->path_length = read_u16(&ptr);
+    if (!read_u16(r, &packet->path_length)) return false;
     if (packet->path_length > BLE_DISCOVERY_MAX_PATH_LENGTH) {
-        return 0; // Invalid path length
+        return false; // Invalid path length
     }
 
     for (uint16_t i = 0; i < packet->path_length; i++) {
-        packet->path[i] = read_u32(&ptr);
+        if (!read_u32(r, &packet->path[i])) return false;
     }
 
     // Read GPS availability
-    packet->gps_available = (read_u8(&ptr) == 1);
+    uint8_t gps;
+    if (!read_u8(r, &gps)) return false;
+    packet->gps_available = (gps == 1);
     if (packet->gps_available) {
-        packet->gps_location.x = read_double(&ptr);
-        packet->gps_location.y = read_double(&ptr);
-        packet->gps_location.z = read_double(&ptr);
+        if (!read_double(r, &packet->gps_location.x) ||
+            !read_double(r, &packet->gps_location.y) ||
+            !read_double(r, &packet->gps_location.z)) {
+            return false;
+        }
     }
 
-    return (uint32_t)(ptr - buffer);
+    return true;
+}
+
+/**
+ * @brief Read the discovery fields in the compact format
+ * @param header First byte of the packet, already consumed
+ */
+static bool read_discovery_compact(ble_discovery_packet_t *packet,
+                                   uint8_t header,
+                                   read_state_t *r)
+{
+    if ((header & BLE_COMPACT_MARKER) != BLE_COMPACT_MARKER ||
+        ((header >> 4) & 0x03) != BLE_COMPACT_VERSION) {
+        return false; // Not compact, or unknown version
+    }
+    packet->message_type = (header & BLE_COMPACT_FLAG_ELECTION) ?
+        BLE_MSG_ELECTION_ANNOUNCEMENT : BLE_MSG_DISCOVERY;
+    packet->gps_available = (header & BLE_COMPACT_FLAG_GPS) != 0;
+
+    // Read TTL and sender ID
+    if (!read_u8(r, &packet->ttl)) return false;
+    if (!read_varint(r, &packet->sender_id)) return false;
+
+    // Read Path So Far
+    uint32_t value;
+    if (!read_varint(r, &value)) return false;
+    if (value > BLE_DISCOVERY_MAX_PATH_LENGTH) {
+        return false; // Invalid path length
+    }
+    packet->path_length = (uint16_t)value;
+
+    uint32_t prev = 0;
+    for (uint16_t i = 0; i < packet->path_length; i++) {
+        if (!read_varint(r, &value)) return false;
+        prev += (uint32_t)zigzag_decode(value);
+        packet->path[i] = prev;
+    }
+
+    // Read GPS coordinates
+    if (packet->gps_available) {
+        double *coordinates[3] = {
+            &packet->gps_location.x, &packet->gps_location.y, &packet->gps_location.z
+        };
+        for (int i = 0; i < 3; i++) {
+            if (!read_varint(r, &value)) return false;
+            *coordinates[i] = zigzag_decode(value) / BLE_COMPACT_GPS_SCALE;
+        }
+    } else {
+        packet->gps_location.x = 0.0;
+        packet->gps_location.y = 0.0;
+        packet->gps_location.z = 0.0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write the election fields following the discovery fields
+ */
+static void write_election_fields(const ble_election_data_t *election,
+                                  ble_wire_format_t format,
+                                  const ble_packet_writer_t *w)
+{
+    if (format == BLE_WIRE_FORMAT_COMPACT) {
+        write_varint(w, election->class_id);
+        write_varint(w, election->pdsf);
+        write_varint(w, election->pdsf_product);
+        write_u16(w, quantize_score(election->score));
+    } else {
+        write_u16(w, election->class_id);
+        // The legacy layout has no version, the product stays off the air
+        write_u32(w, election->pdsf);
+        write_double(w, election->score);
+    }
+    write_u32(w, election->hash);
+}
+
+/**
+ * @brief Read the election fields following the discovery fields
+ */
+static bool read_election_fields(ble_election_data_t *election,
+                                 ble_wire_format_t format,
+                                 read_state_t *r)
+{
+    if (format == BLE_WIRE_FORMAT_COMPACT) {
+        uint32_t value;
+        uint16_t score;
+        if (!read_varint(r, &value) || value > 0xFFFF) return false;
+        election->class_id = (uint16_t)value;
+        if (!read_varint(r, &election->pdsf)) return false;
+        if (!read_varint(r, &election->pdsf_product)) return false;
+        if (!read_u16(r, &score)) return false;
+        election->score = score / BLE_COMPACT_SCORE_SCALE;
+    } else {
+        if (!read_u16(r, &election->class_id)) return false;
+        if (!read_u32(r, &election->pdsf)) return false;
+        election->pdsf_product = 0;
+        if (!read_double(r, &election->score)) return false;
+    }
+    return read_u32(r, &election->hash);
+}
+
+/**
+ * @brief Read the first byte and the discovery fields in the given format
+ */
+static bool read_discovery(ble_discovery_packet_t *packet,
+                           ble_wire_format_t format,
+                           read_state_t *r)
+{
+    uint8_t first;
+    if (!read_u8(r, &first)) return false;
+    if (format == BLE_WIRE_FORMAT_COMPACT) {
+        return read_discovery_compact(packet, first, r);
+    }
+    return read_discovery_legacy(packet, first, r);
+}
+
+uint32_t ble_discovery_write(const ble_discovery_packet_t *packet,
+                               ble_wire_format_t format,
+                               const ble_packet_writer_t *writer)
+{
+    if (!packet || !writer || !writer->write_u8) return 0;
+
+    if (format == BLE_WIRE_FORMAT_COMPACT) {
+        uint32_t size = ble_discovery_get_compact_size(packet);
+        if (size == 0) return 0;
+        write_discovery_compact(packet, compact_header(packet), writer);
+        return size;
+    }
+    write_discovery_legacy(packet, writer);
+    return ble_discovery_get_size(packet);
+}
+
+uint32_t ble_discovery_read(ble_discovery_packet_t *packet,
+                              ble_wire_format_t format,
+                              const ble_packet_reader_t *reader)
+{
+    if (!packet || !reader || !reader->read_u8) return 0;
+
+    read_state_t r = { reader, 0 };
+    if (!read_discovery(packet, format, &r)) return 0;
+    return r.count;
+}
+
+uint32_t ble_election_write(const ble_election_packet_t *packet,
+                              ble_wire_format_t format,
+                              const ble_packet_writer_t *writer)
+{
+    if (!packet || !writer || !writer->write_u8) return 0;
+
+    if (format == BLE_WIRE_FORMAT_COMPACT) {
+        uint32_t size = ble_election_get_compact_size(packet);
+        if (size == 0) return 0;
+        // The election flag must be set even if the base type was not
+        write_discovery_compact(&packet->base,
+                                compact_header(&packet->base) | BLE_COMPACT_FLAG_ELECTION,
+                                writer);
+        write_election_fields(&packet->election, format, writer);
+        return size;
+    }
+    write_discovery_legacy(&packet->base, writer);
+    write_election_fields(&packet->election, format, writer);
+    return ble_election_get_size(packet);
+}
+
+uint32_t ble_election_read(ble_election_packet_t *packet,
+                             ble_wire_format_t format,
+                             const ble_packet_reader_t *reader)
+{
+    if (!packet || !reader || !reader->read_u8) return 0;
+
+    read_state_t r = { reader, 0 };
+    if (!read_discovery(&packet->base, format, &r)) return 0;
+    if (format == BLE_WIRE_FORMAT_COMPACT &&
+        packet->base.message_type != BLE_MSG_ELECTION_ANNOUNCEMENT) {
+        return 0;
+    }
+    if (!read_election_fields(&packet->election, format, &r)) return 0;
+    return r.count;
+}
+
+/* ===== Serialization ===== */
+
+uint32_t ble_discovery_serialize(const ble_discovery_packet_t *packet,
+                                   uint8_t *buffer,
+                                   uint32_t buffer_size)
+{
+    if (!packet || !buffer) return 0;
+
+    uint32_t required_size = ble_discovery_get_size(packet);
+    if (buffer_size < required_size) return 0;
+
+    uint8_t *ptr = buffer;
+    ble_packet_writer_t writer = { buffer_write_u8, &ptr };
+    return ble_discovery_write(packet, BLE_WIRE_FORMAT_LEGACY, &writer);
+}
+
+uint32_t ble_discovery_deserialize(ble_discovery_packet_t *packet,
+                                     const uint8_t *buffer,
+                                     uint32_t buffer_size)
+{
+    if (!packet || !buffer || buffer_size < 6) return 0;
+
+    buffer_input_t input = { buffer, buffer + buffer_size };
+    ble_packet_reader_t reader = { buffer_read_u8, &input };
+    return ble_discovery_read(packet, BLE_WIRE_FORMAT_LEGACY, &reader);
 }
 
 uint32_t ble_election_serialize(const ble_election_packet_t *packet,
@@ -298,19 +674,9 @@ uint32_t ble_election_serialize(const ble_election_packet_t *packet,
     uint32_t required_size = ble_election_get_size(packet);
     if (buffer_size < required_size) return 0;
 
-    // Serialize base discovery packet
-    uint32_t bytes_written = ble_discovery_serialize(&packet->base, buffer, buffer_size);
-    if (bytes_written == 0) return 0;
-
-    uint8_t *ptr = buffer + bytes_written;
-
-    // Write election-specific fields
-    write_u16(&ptr, packet->election.class_id);
-    write_u32(&ptr, packet->election.pdsf);
-    write_double(&ptr, packet->election.score);
-    write_u32(&ptr, packet->election.hash);
-
-    return (uint32_t)(ptr - buffer);
+    uint8_t *ptr = buffer;
+    ble_packet_writer_t writer = { buffer_write_u8, &ptr };
+    return ble_election_write(packet, BLE_WIRE_FORMAT_LEGACY, &writer);
 }
 
 uint32_t ble_election_deserialize(ble_election_packet_t *packet,
@@ -319,40 +685,188 @@ uint32_t ble_election_deserialize(ble_election_packet_t *packet,
 {
     if (!packet || !buffer) return 0;
 
-    // Deserialize base discovery packet
-    uint32_t bytes_read = ble_discovery_deserialize(&packet->base, buffer, buffer_size);
-    if (bytes_read == 0) return 0;
+    buffer_input_t input = { buffer, buffer + buffer_size };
+    ble_packet_reader_t reader = { buffer_read_u8, &input };
+    return ble_election_read(packet, BLE_WIRE_FORMAT_LEGACY, &reader);
+}
 
-    const uint8_t *ptr = buffer + bytes_read;
+/* ===== Compact Format ===== */
 
-    // Read election-specific fields
-    packet->election.class_id = read_u16(&ptr);
-    packet->election.pdsf = read_u32(&ptr);
-    packet->election.score = read_double(&ptr);
-    packet->election.hash = read_u32(&ptr);
+ble_wire_format_t ble_discovery_detect_format(const uint8_t *buffer, uint32_t buffer_size)
+{
+    if (!buffer || buffer_size == 0) return BLE_WIRE_FORMAT_LEGACY;
 
-    return (uint32_t)(ptr - buffer);
+    if ((buffer[0] & BLE_COMPACT_MARKER) == BLE_COMPACT_MARKER) {
+        return BLE_WIRE_FORMAT_COMPACT;
+    }
+    return BLE_WIRE_FORMAT_LEGACY;
+}
+
+uint32_t ble_discovery_get_compact_size(const ble_discovery_packet_t *packet)
+{
+    if (!packet) return 0;
+    if (packet->path_length > BLE_DISCOVERY_MAX_PATH_LENGTH) return 0;
+
+    // Header (1) + TTL (1) + Sender ID (varint)
+    uint32_t size = 1 + 1 + varint_size(packet->sender_id);
+
+    // PSF: length (varint) + deltas to the previous node ID (zigzag varints)
+    size += varint_size(packet->path_length);
+    uint32_t prev = 0;
+    for (uint16_t i = 0; i < packet->path_length; i++) {
+        size += varint_size(path_delta(prev, packet->path[i]));
+        prev = packet->path[i];
+    }
+
+    // GPS: fixed-point coordinates (zigzag varints), flag is in the header
+    if (packet->gps_available) {
+        size += varint_size(zigzag_encode(quantize_gps(packet->gps_location.x)));
+        size += varint_size(zigzag_encode(quantize_gps(packet->gps_location.y)));
+        size += varint_size(zigzag_encode(quantize_gps(packet->gps_location.z)));
+    }
+
+    return size;
+}
+
+uint32_t ble_election_get_compact_size(const ble_election_packet_t *packet)
+{
+    if (!packet) return 0;
+
+    uint32_t size = ble_discovery_get_compact_size(&packet->base);
+    if (size == 0) return 0;
+
+    // Class ID (varint) + PDSF (varint) + PDSF product (varint) + Score (2) + Hash (4)
+    size += varint_size(packet->election.class_id);
+    size += varint_size(packet->election.pdsf);
+    size += varint_size(packet->election.pdsf_product);
+    size += 2 + 4;
+
+    return size;
+}
+
+uint32_t ble_discovery_serialize_compact(const ble_discovery_packet_t *packet,
+                                           uint8_t *buffer,
+                                           uint32_t buffer_size)
+{
+    if (!packet || !buffer) return 0;
+
+    uint32_t required_size = ble_discovery_get_compact_size(packet);
+    if (required_size == 0 || buffer_size < required_size) return 0;
+
+    uint8_t *ptr = buffer;
+    ble_packet_writer_t writer = { buffer_write_u8, &ptr };
+    return ble_discovery_write(packet, BLE_WIRE_FORMAT_COMPACT, &writer);
+}
+
+uint32_t ble_discovery_deserialize_compact(ble_discovery_packet_t *packet,
+                                             const uint8_t *buffer,
+                                             uint32_t buffer_size)
+{
+    if (!packet || !buffer || buffer_size < 4) return 0;
+
+    buffer_input_t input = { buffer, buffer + buffer_size };
+    ble_packet_reader_t reader = { buffer_read_u8, &input };
+    return ble_discovery_read(packet, BLE_WIRE_FORMAT_COMPACT, &reader);
+}
+
+uint32_t ble_election_serialize_compact(const ble_election_packet_t *packet,
+                                          uint8_t *buffer,
+                                          uint32_t buffer_size)
+{
+    if (!packet || !buffer) return 0;
+
+    uint32_t required_size = ble_election_get_compact_size(packet);
+    if (required_size == 0 || buffer_size < required_size) return 0;
+
+    uint8_t *ptr = buffer;
+    ble_packet_writer_t writer = { buffer_write_u8, &ptr };
+    return ble_election_write(packet, BLE_WIRE_FORMAT_COMPACT, &writer);
+}
+
+uint32_t ble_election_deserialize_compact(ble_election_packet_t *packet,
+                                            const uint8_t *buffer,
+                                            uint32_t buffer_size)
+{
+    if (!packet || !buffer) return 0;
+
+    buffer_input_t input = { buffer, buffer + buffer_size };
+    ble_packet_reader_t reader = { buffer_read_u8, &input };
+    return ble_election_read(packet, BLE_WIRE_FORMAT_COMPACT, &reader);
 }
 
 /* ===== Election Calculations ===== */
 
+/**
+ * @brief Add without wrapping around
+ */
+static inline uint64_t saturating_add(uint64_t a, uint64_t b)
+{
+    return (a > UINT64_MAX - b) ? UINT64_MAX : a + b;
+}
+
+/**
+ * @brief Multiply without wrapping around
+ */
+static inline uint64_t saturating_mul(uint64_t a, uint64_t b)
+{
+    if (a != 0 && b > UINT64_MAX / a) return UINT64_MAX;
+    return a * b;
+}
+
+/**
+ * @brief Narrow to 32 bits without wrapping around
+ */
+static inline uint32_t saturate_u32(uint64_t value)
+{
+    return value > UINT32_MAX ? UINT32_MAX : (uint32_t)value;
+}
+
 uint32_t ble_election_calculate_pdsf(const uint32_t *direct_counts, uint16_t hop_count)
 {
     if (!direct_counts || hop_count == 0) return 0;
 
     // t(x) = Σᵢ Πᵢ(xᵢ)
-    // Sum of products of direct connections at each hop
-    uint32_t pdsf = 0;
-
+    // Sum of products of direct connections at each hop, each product
+    // extending the previous one
+    ble_pdsf_accumulator_t accumulator;
+    ble_pdsf_init(&accumulator);
     for (uint16_t i = 0; i < hop_count; i++) {
-        uint32_t product = 1;
-        for (uint16_t j = 0; j <= i; j++) {
-            product *= direct_counts[j];
-        }
-        pdsf += product;
+        ble_pdsf_append(&accumulator, direct_counts[i]);
     }
+    return ble_pdsf_value(&accumulator);
+}
+
+void ble_pdsf_init(ble_pdsf_accumulator_t *accumulator)
+{
+    if (!accumulator) return;
+
+    accumulator->sum = 0;
+    accumulator->product = 1;
+}
+
+void ble_pdsf_append(ble_pdsf_accumulator_t *accumulator, uint32_t direct_count)
+{
+    if (!accumulator) return;
+
+    accumulator->product = saturating_mul(accumulator->product, direct_count);
+    accumulator->sum = saturating_add(accumulator->sum, accumulator->product);
+}
+
+uint32_t ble_pdsf_value(const ble_pdsf_accumulator_t *accumulator)
+{
+    if (!accumulator) return 0;
+    return saturate_u32(accumulator->sum);
+}
+
+void ble_election_append_pdsf(ble_election_data_t *election, uint32_t direct_count)
+{
+    if (!election) return;
 
-    return pdsf;
+    // Saturated 32-bit values stay saturated: the sum is at least the product
+    ble_pdsf_accumulator_t accumulator = { election->pdsf, election->pdsf_product };
+    ble_pdsf_append(&accumulator, direct_count);
+    election->pdsf = saturate_u32(accumulator.sum);
+    election->pdsf_product = saturate_u32(accumulator.product);
 }
 
 double ble_election_calculate_score(uint32_t direct_connections,
@@ -41,11 +41,16 @@ typedef enum {
 
 /**
  * @brief GPS coordinates structure
+ *
+ * Positions are Cartesian coordinates in meters, as given by the NS-3
+ * mobility models, not latitude and longitude in degrees. Proximity
+ * filtering takes Euclidean distances between them, and the compact
+ * encodings store them in centimeters.
  */
 typedef struct {
-    double x;  /**< X coordinate (latitude) */
-    double y;  /**< Y coordinate (longitude) */
-    double z;  /**< Z coordinate (altitude) */
+    double x;  /**< X coordinate (m) */
+    double y;  /**< Y coordinate (m) */
+    double z;  /**< Z coordinate, height (m) */
 } ble_gps_location_t;
 
 /* ===== Discovery Packet Structure ===== */
@@ -75,10 +80,24 @@ typedef struct {
 typedef struct {
     uint16_t class_id;   /**< Clusterhead class identifier */
     uint32_t pdsf;       /**< Predicted Devices So Far */
+    uint32_t pdsf_product; /**< Last PDSF term: product of the direct counts so far
+                                (compact format only, 0 after a legacy decode) */
     double score;        /**< Clusterhead candidacy score (0.0-1.0) */
     uint32_t hash;       /**< FDMA/TDMA hash function value */
 } ble_election_data_t;
 
+/**
+ * @brief Running state of a PDSF computation
+ *
+ * PDSF is t(x) = Σᵢ Πⱼ≤ᵢ(xⱼ) over the direct counts xⱼ along a path. Keeping
+ * the last product makes appending a hop O(1). Both values saturate at
+ * UINT64_MAX instead of wrapping.
+ */
+typedef struct {
+    uint64_t sum;        /**< PDSF so far */
+    uint64_t product;    /**< Product of the direct counts so far (1 with no hops) */
+} ble_pdsf_accumulator_t;
+
 /**
  * @brief Complete election announcement packet
  */
@@ -87,6 +106,51 @@ typedef struct {
     ble_election_data_t election; /**< Election-specific fields */
 } ble_election_packet_t;
 
+/* ===== Wire Formats ===== */
+
+/**
+ * @brief Encoding of packets on the air
+ *
+ * The legacy format uses fixed-width fields. The compact format starts with
+ * a byte whose two top bits are set, which no legacy message type uses, so
+ * receivers can accept both formats (see ble_discovery_detect_format()).
+ */
+typedef enum {
+    BLE_WIRE_FORMAT_LEGACY = 0,  /**< Fixed-width fields, IEEE 754 GPS */
+    BLE_WIRE_FORMAT_COMPACT = 1  /**< Varints, delta-coded path, fixed-point GPS */
+} ble_wire_format_t;
+
+#define BLE_COMPACT_MARKER 0xC0          /**< Top bits of a compact header byte */
+#define BLE_COMPACT_VERSION 2            /**< Version in bits 5-4 of the header byte */
+#define BLE_COMPACT_FLAG_ELECTION 0x01   /**< Header flag: election announcement */
+#define BLE_COMPACT_FLAG_GPS 0x02        /**< Header flag: GPS coordinates follow */
+#define BLE_COMPACT_GPS_SCALE 100.0      /**< Fixed-point GPS steps per meter (1 cm) */
+#define BLE_COMPACT_SCORE_SCALE 65535.0  /**< Fixed-point steps of the score in [0.0, 1.0] */
+
+/* ===== Byte Streams ===== */
+
+/**
+ * @brief Destination of serialized bytes
+ *
+ * Lets callers serialize straight into their own storage (e.g. a network
+ * buffer) without an intermediate copy. The writer must accept as many bytes
+ * as the get_size functions report.
+ */
+typedef struct {
+    void (*write_u8)(void *context, uint8_t value); /**< Append one byte */
+    void *context;                                  /**< Passed to write_u8 */
+} ble_packet_writer_t;
+
+/**
+ * @brief Source of serialized bytes
+ *
+ * Only the bytes of the packet itself are consumed.
+ */
+typedef struct {
+    bool (*read_u8)(void *context, uint8_t *value); /**< Consume one byte, false at the end */
+    void *context;                                  /**< Passed to read_u8 */
+} ble_packet_reader_t;
+
 /* ===== Function Prototypes ===== */
 
 /**
@@ -127,9 +191,9 @@ bool ble_discovery_is_in_path(const ble_discovery_packet_t *packet, uint32_t nod
 /**
  * @brief Set GPS location
  * @param packet Pointer to packet structure
- * @param x X coordinate (latitude)
- * @param y Y coordinate (longitude)
- * @param z Z coordinate (altitude)
+ * @param x X coordinate (m)
+ * @param y Y coordinate (m)
+ * @param z Z coordinate, height (m)
  */
 void ble_discovery_set_gps(ble_discovery_packet_t *packet, double x, double y, double z);
 
@@ -182,6 +246,10 @@ uint32_t ble_election_serialize(const ble_election_packet_t *packet,
 
 /**
  * @brief Deserialize election packet from buffer
+ *
+ * The legacy format does not carry the PDSF product, so pdsf_product is
+ * set to 0. Appending to such an announcement leaves its PDSF unchanged.
+ *
  * @param packet Pointer to election packet structure to fill
  * @param buffer Input buffer
  * @param buffer_size Size of input buffer
@@ -191,14 +259,164 @@ uint32_t ble_election_deserialize(ble_election_packet_t *packet,
                                     const uint8_t *buffer,
                                     uint32_t buffer_size);
 
+/**
+ * @brief Detect the wire format of a received packet
+ * @param buffer Input buffer
+ * @param buffer_size Size of input buffer
+ * @return BLE_WIRE_FORMAT_COMPACT if the first byte carries the compact marker,
+ *         BLE_WIRE_FORMAT_LEGACY otherwise
+ */
+ble_wire_format_t ble_discovery_detect_format(const uint8_t *buffer, uint32_t buffer_size);
+
+/**
+ * @brief Calculate compact serialized size of discovery packet
+ * @param packet Pointer to packet structure
+ * @return Size in bytes, or 0 on error
+ */
+uint32_t ble_discovery_get_compact_size(const ble_discovery_packet_t *packet);
+
+/**
+ * @brief Calculate compact serialized size of election packet
+ * @param packet Pointer to election packet structure
+ * @return Size in bytes, or 0 on error
+ */
+uint32_t ble_election_get_compact_size(const ble_election_packet_t *packet);
+
+/**
+ * @brief Serialize discovery packet to buffer in the compact format
+ *
+ * GPS coordinates are meters, rounded to 1/BLE_COMPACT_GPS_SCALE (1 cm) and
+ * saturated at the limits of a 32-bit fixed-point value (about ±21474 km).
+ *
+ * @param packet Pointer to packet structure
+ * @param buffer Output buffer
+ * @param buffer_size Size of output buffer
+ * @return Number of bytes written, or 0 on error
+ */
+uint32_t ble_discovery_serialize_compact(const ble_discovery_packet_t *packet,
+                                           uint8_t *buffer,
+                                           uint32_t buffer_size);
+
+/**
+ * @brief Deserialize discovery packet in the compact format from buffer
+ * @param packet Pointer to packet structure to fill
+ * @param buffer Input buffer
+ * @param buffer_size Size of input buffer
+ * @return Number of bytes read, or 0 on error (truncated, unknown version)
+ */
+uint32_t ble_discovery_deserialize_compact(ble_discovery_packet_t *packet,
+                                             const uint8_t *buffer,
+                                             uint32_t buffer_size);
+
+/**
+ * @brief Serialize election packet to buffer in the compact format
+ *
+ * The score is rounded to 1/BLE_COMPACT_SCORE_SCALE and clamped to [0.0, 1.0].
+ *
+ * @param packet Pointer to election packet structure
+ * @param buffer Output buffer
+ * @param buffer_size Size of output buffer
+ * @return Number of bytes written, or 0 on error
+ */
+uint32_t ble_election_serialize_compact(const ble_election_packet_t *packet,
+                                          uint8_t *buffer,
+                                          uint32_t buffer_size);
+
+/**
+ * @brief Deserialize election packet in the compact format from buffer
+ * @param packet Pointer to election packet structure to fill
+ * @param buffer Input buffer
+ * @param buffer_size Size of input buffer
+ * @return Number of bytes read, or 0 on error (also if not an election packet)
+ */
+uint32_t ble_election_deserialize_compact(ble_election_packet_t *packet,
+                                            const uint8_t *buffer,
+                                            uint32_t buffer_size);
+
+/**
+ * @brief Serialize discovery packet to a writer
+ * @param packet Pointer to packet structure
+ * @param format Wire format
+ * @param writer Destination of the bytes
+ * @return Number of bytes written, or 0 on error
+ */
+uint32_t ble_discovery_write(const ble_discovery_packet_t *packet,
+                               ble_wire_format_t format,
+                               const ble_packet_writer_t *writer);
+
+/**
+ * @brief Deserialize discovery packet from a reader
+ * @param packet Pointer to packet structure to fill
+ * @param format Wire format (see ble_discovery_detect_format())
+ * @param reader Source of the bytes
+ * @return Number of bytes read, or 0 on error
+ */
+uint32_t ble_discovery_read(ble_discovery_packet_t *packet,
+                              ble_wire_format_t format,
+                              const ble_packet_reader_t *reader);
+
+/**
+ * @brief Serialize election packet to a writer
+ * @param packet Pointer to election packet structure
+ * @param format Wire format
+ * @param writer Destination of the bytes
+ * @return Number of bytes written, or 0 on error
+ */
+uint32_t ble_election_write(const ble_election_packet_t *packet,
+                              ble_wire_format_t format,
+                              const ble_packet_writer_t *writer);
+
+/**
+ * @brief Deserialize election packet from a reader
+ * @param packet Pointer to election packet structure to fill
+ * @param format Wire format (see ble_discovery_detect_format())
+ * @param reader Source of the bytes
+ * @return Number of bytes read, or 0 on error
+ */
+uint32_t ble_election_read(ble_election_packet_t *packet,
+                             ble_wire_format_t format,
+                             const ble_packet_reader_t *reader);
+
 /**
  * @brief Calculate PDSF (Predicted Devices So Far)
  * @param direct_counts Array of direct connection counts at each hop
  * @param hop_count Number of hops
- * @return PDSF value
+ * @return PDSF value, saturated at UINT32_MAX
  */
 uint32_t ble_election_calculate_pdsf(const uint32_t *direct_counts, uint16_t hop_count);
 
+/**
+ * @brief Start a PDSF computation with no hops
+ * @param accumulator Pointer to accumulator
+ */
+void ble_pdsf_init(ble_pdsf_accumulator_t *accumulator);
+
+/**
+ * @brief Add the direct count of the next hop, in O(1)
+ * @param accumulator Pointer to accumulator
+ * @param direct_count Direct connection count at the hop
+ */
+void ble_pdsf_append(ble_pdsf_accumulator_t *accumulator, uint32_t direct_count);
+
+/**
+ * @brief Get the PDSF as carried in announcements
+ * @param accumulator Pointer to accumulator
+ * @return PDSF value, saturated at UINT32_MAX
+ */
+uint32_t ble_pdsf_value(const ble_pdsf_accumulator_t *accumulator);
+
+/**
+ * @brief Append a forwarding node's direct count to a received announcement
+ *
+ * Updates pdsf and pdsf_product in O(1), saturating at UINT32_MAX. With a
+ * product of 0 (a zero direct count so far, or a legacy announcement that
+ * did not carry the product) the PDSF does not grow.
+ *
+ * @param election Election fields of the announcement
+ * @param direct_count Direct connection count of the forwarding node
+ */
+void ble_election_append_pdsf(ble_election_data_t *election, uint32_t direct_count);
+
 /**
  * @brief Calculate clusterhead candidacy score
  * @param direct_connections Number of direct connections
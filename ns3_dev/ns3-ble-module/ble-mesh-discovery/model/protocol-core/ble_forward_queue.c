@@ -0,0 +1,178 @@
+/**
+ * @file ble_forward_queue.c
+ * @brief Pure C TTL-priority queue of discovery messages awaiting forwarding
+ */
+
+#include "ble_forward_queue.h"
+#include <string.h>
+
+#if BLE_FORWARD_QUEUE_BUCKETS > 16
+#error "The occupied bucket mask holds at most 16 TTL buckets"
+#endif
+
+#if BLE_FORWARD_QUEUE_CAPACITY < 1 || BLE_FORWARD_QUEUE_CAPACITY >= BLE_FORWARD_QUEUE_NONE
+#error "Queue entries are indexed by uint8_t"
+#endif
+
+/* ===== Helper Functions ===== */
+
+/**
+ * @brief Bucket of a TTL value
+ */
+static inline uint8_t queue_bucket(uint8_t ttl)
+{
+    return ttl > BLE_DISCOVERY_DEFAULT_TTL ? BLE_DISCOVERY_DEFAULT_TTL : ttl;
+}
+
+/**
+ * @brief Highest non-empty bucket (the mask must be non-zero)
+ */
+static inline uint8_t queue_highest_bucket(uint16_t occupied)
+{
+    uint8_t bucket = BLE_FORWARD_QUEUE_BUCKETS - 1;
+    while (!(occupied & (1u << bucket))) {
+        bucket--;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Lowest non-empty bucket (the mask must be non-zero)
+ */
+static inline uint8_t queue_lowest_bucket(uint16_t occupied)
+{
+    uint8_t bucket = 0;
+    while (!(occupied & (1u << bucket))) {
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Unlink the oldest entry of a bucket and return its index
+ */
+static uint8_t queue_unlink_head(ble_forward_queue_t *queue, uint8_t bucket)
+{
+    uint8_t entry = queue->head[bucket];
+    queue->head[bucket] = queue->next[entry];
+    if (queue->head[bucket] == BLE_FORWARD_QUEUE_NONE) {
+        queue->tail[bucket] = BLE_FORWARD_QUEUE_NONE;
+        queue->occupied &= (uint16_t)~(1u << bucket);
+    }
+    queue->count--;
+    return entry;
+}
+
+/**
+ * @brief Return an entry to the free list
+ */
+static inline void queue_release(ble_forward_queue_t *queue, uint8_t entry)
+{
+    queue->next[entry] = queue->free_head;
+    queue->free_head = entry;
+}
+
+/* ===== Initialization ===== */
+
+void ble_forward_queue_init(ble_forward_queue_t *queue)
+{
+    if (!queue) return;
+
+    queue->evicted = 0;
+    queue->rejected = 0;
+    ble_forward_queue_clear(queue);
+}
+
+void ble_forward_queue_clear(ble_forward_queue_t *queue)
+{
+    if (!queue) return;
+
+    for (uint8_t i = 0; i < BLE_FORWARD_QUEUE_CAPACITY; i++) {
+        queue->next[i] = (uint8_t)(i + 1 < BLE_FORWARD_QUEUE_CAPACITY ? i + 1
+                                                                      : BLE_FORWARD_QUEUE_NONE);
+    }
+    memset(queue->head, BLE_FORWARD_QUEUE_NONE, sizeof(queue->head));
+    memset(queue->tail, BLE_FORWARD_QUEUE_NONE, sizeof(queue->tail));
+    queue->free_head = 0;
+    queue->occupied = 0;
+    queue->count = 0;
+}
+
+/* ===== Insertion ===== */
+
+bool ble_forward_queue_push(ble_forward_queue_t *queue, const ble_discovery_packet_t *packet)
+{
+    if (!queue || !packet) return false;
+
+    if (packet->ttl == 0) {
+        queue->rejected++;
+        return false;
+    }
+
+    uint8_t bucket = queue_bucket(packet->ttl);
+    if (queue->free_head == BLE_FORWARD_QUEUE_NONE) {
+        // Full: displace the oldest message of the lowest TTL, if lower than ours
+        uint8_t lowest = queue_lowest_bucket(queue->occupied);
+        if (lowest >= bucket) {
+            queue->rejected++;
+            return false;
+        }
+        queue_release(queue, queue_unlink_head(queue, lowest));
+        queue->evicted++;
+    }
+
+    uint8_t entry = queue->free_head;
+    queue->free_head = queue->next[entry];
+    queue->packets[entry] = *packet;
+    queue->next[entry] = BLE_FORWARD_QUEUE_NONE;
+
+    if (queue->tail[bucket] == BLE_FORWARD_QUEUE_NONE) {
+        queue->head[bucket] = entry;
+        queue->occupied |= (uint16_t)(1u << bucket);
+    } else {
+        queue->next[queue->tail[bucket]] = entry;
+    }
+    queue->tail[bucket] = entry;
+    queue->count++;
+    return true;
+}
+
+/* ===== Extraction ===== */
+
+const ble_discovery_packet_t* ble_forward_queue_peek(const ble_forward_queue_t *queue)
+{
+    if (!queue || queue->count == 0) return NULL;
+
+    return &queue->packets[queue->head[queue_highest_bucket(queue->occupied)]];
+}
+
+bool ble_forward_queue_pop(ble_forward_queue_t *queue, ble_discovery_packet_t *packet)
+{
+    if (!queue || queue->count == 0) return false;
+
+    uint8_t entry = queue_unlink_head(queue, queue_highest_bucket(queue->occupied));
+    if (packet) {
+        *packet = queue->packets[entry];
+    }
+    queue_release(queue, entry);
+    return true;
+}
+
+uint16_t ble_forward_queue_pop_top(ble_forward_queue_t *queue,
+                                   ble_discovery_packet_t *packets,
+                                   uint16_t max_count)
+{
+    if (!queue || !packets) return 0;
+
+    uint16_t popped = 0;
+    while (popped < max_count && ble_forward_queue_pop(queue, &packets[popped])) {
+        popped++;
+    }
+    return popped;
+}
+
+uint16_t ble_forward_queue_count(const ble_forward_queue_t *queue)
+{
+    if (!queue) return 0;
+    return queue->count;
+}
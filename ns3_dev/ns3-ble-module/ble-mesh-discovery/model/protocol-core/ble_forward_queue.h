@@ -0,0 +1,131 @@
+/**
+ * @file ble_forward_queue.h
+ * @brief Pure C TTL-priority queue of discovery messages awaiting forwarding
+ *
+ * After picky forwarding and GPS proximity filtering, the remaining messages
+ * are relayed in order of TTL, at most BLE_FORWARD_SLOTS_PER_CYCLE per
+ * discovery cycle. The queue keeps one FIFO bucket per TTL value
+ * (0..BLE_DISCOVERY_DEFAULT_TTL) over a fixed pool of entries, so insertion,
+ * extraction of the highest TTL and eviction of the lowest TTL are all O(1).
+ *
+ * The memory is fixed (no malloc). The queue is kept by the caller next to
+ * its ble_mesh_node_t, not inside it. Can be compiled without NS-3 or any
+ * C++ dependencies.
+ */
+
+#ifndef BLE_FORWARD_QUEUE_H
+#define BLE_FORWARD_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_discovery_packet.h"
+
+/* ===== Constants ===== */
+
+/*
+ * Every entry holds a whole ble_discovery_packet_t (about 240 bytes), so the
+ * default keeps the queue under 2 KB for embedded targets. Three messages
+ * leave per cycle, so 8 entries hold more than two cycles of backlog. It may
+ * be defined on the compiler command line, and must then be the same for
+ * every file that includes this header.
+ *
+ * BLE_FORWARD_QUEUE_CAPACITY     Messages held per queue (1 to 254)
+ */
+
+#ifndef BLE_FORWARD_QUEUE_CAPACITY
+#define BLE_FORWARD_QUEUE_CAPACITY 8        /**< Messages held per queue */
+#endif
+
+#define BLE_FORWARD_SLOTS_PER_CYCLE 3       /**< Messages forwarded per discovery cycle */
+#define BLE_FORWARD_QUEUE_BUCKETS (BLE_DISCOVERY_DEFAULT_TTL + 1) /**< One per TTL */
+#define BLE_FORWARD_QUEUE_NONE 0xFF         /**< End of a bucket list */
+
+/* ===== Queue Structure ===== */
+
+/**
+ * @brief Fixed-capacity forwarding queue bucketed by TTL
+ *
+ * Messages with a TTL above BLE_DISCOVERY_DEFAULT_TTL share the highest
+ * bucket. Within a bucket, messages leave in arrival order.
+ */
+typedef struct {
+    ble_discovery_packet_t packets[BLE_FORWARD_QUEUE_CAPACITY]; /**< Entry pool */
+    uint8_t next[BLE_FORWARD_QUEUE_CAPACITY]; /**< Next entry in bucket or free list */
+    uint8_t head[BLE_FORWARD_QUEUE_BUCKETS];  /**< Oldest entry per bucket */
+    uint8_t tail[BLE_FORWARD_QUEUE_BUCKETS];  /**< Newest entry per bucket */
+    uint8_t free_head;            /**< First unused entry */
+    uint16_t occupied;            /**< Bitmask of non-empty buckets */
+    uint16_t count;               /**< Messages queued */
+    uint32_t evicted;             /**< Messages displaced by a higher TTL */
+    uint32_t rejected;            /**< Messages refused (full or TTL 0) */
+} ble_forward_queue_t;
+
+/* ===== Function Prototypes ===== */
+
+/**
+ * @brief Initialize an empty queue
+ * @param queue Pointer to queue structure
+ */
+void ble_forward_queue_init(ble_forward_queue_t *queue);
+
+/**
+ * @brief Remove all messages, keeping the eviction counters
+ * @param queue Pointer to queue structure
+ */
+void ble_forward_queue_clear(ble_forward_queue_t *queue);
+
+/**
+ * @brief Queue a message for forwarding
+ *
+ * Messages with TTL 0 cannot be forwarded and are refused. When the queue is
+ * full, the oldest message of the lowest TTL is evicted if the new message
+ * has a higher TTL; otherwise the new message is refused.
+ *
+ * @param queue Pointer to queue structure
+ * @param packet Message to copy into the queue
+ * @return true if queued, false if refused
+ */
+bool ble_forward_queue_push(ble_forward_queue_t *queue, const ble_discovery_packet_t *packet);
+
+/**
+ * @brief Get the message with the highest TTL without removing it
+ * @param queue Pointer to queue structure
+ * @return Pointer to the message, or NULL if the queue is empty
+ */
+const ble_discovery_packet_t* ble_forward_queue_peek(const ble_forward_queue_t *queue);
+
+/**
+ * @brief Remove the message with the highest TTL
+ * @param queue Pointer to queue structure
+ * @param packet Output message (may be NULL to discard)
+ * @return false if the queue is empty
+ */
+bool ble_forward_queue_pop(ble_forward_queue_t *queue, ble_discovery_packet_t *packet);
+
+/**
+ * @brief Remove up to max_count messages in order of decreasing TTL
+ * @param queue Pointer to queue structure
+ * @param packets Output array of at least max_count messages
+ * @param max_count Maximum messages to remove
+ * @return Number of messages removed
+ */
+uint16_t ble_forward_queue_pop_top(ble_forward_queue_t *queue,
+                                   ble_discovery_packet_t *packets,
+                                   uint16_t max_count);
+
+/**
+ * @brief Get number of queued messages
+ * @param queue Pointer to queue structure
+ * @return Message count
+ */
+uint16_t ble_forward_queue_count(const ble_forward_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_FORWARD_QUEUE_H */
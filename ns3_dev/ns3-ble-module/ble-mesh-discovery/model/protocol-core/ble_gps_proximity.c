@@ -0,0 +1,118 @@
+/**
+ * @file ble_gps_proximity.c
+ * @brief Pure C batched GPS proximity test for forwarding decisions
+ */
+
+#include "ble_gps_proximity.h"
+#include <string.h>
+
+#if defined(__SSE2__) && !defined(BLE_GPS_PROXIMITY_SCALAR)
+#include <emmintrin.h>
+#define BLE_GPS_PROXIMITY_SSE2 1
+#endif
+
+/* ===== Helper Functions ===== */
+
+/**
+ * @brief Count set bits of a mask word
+ */
+static inline uint32_t popcount64(uint64_t word)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_popcountll(word);
+#else
+    uint32_t bits = 0;
+    while (word) {
+        word &= word - 1;
+        bits++;
+    }
+    return bits;
+#endif
+}
+
+/**
+ * @brief Mask word of up to 64 points starting at first (scalar)
+ *
+ * Written without branches so that compilers can vectorize it.
+ */
+static uint64_t proximity_word_scalar(const double *x, const double *y, const double *z,
+                                      uint32_t first, uint32_t points,
+                                      double cx, double cy, double cz, double range_sq)
+{
+    uint64_t word = 0;
+    for (uint32_t i = 0; i < points; i++) {
+        double dx = x[first + i] - cx;
+        double dy = y[first + i] - cy;
+        double dz = z[first + i] - cz;
+        uint64_t inside = (dx * dx + dy * dy + dz * dz) <= range_sq;
+        word |= inside << i;
+    }
+    return word;
+}
+
+#ifdef BLE_GPS_PROXIMITY_SSE2
+/**
+ * @brief Mask word of up to 64 points starting at first (two points per step)
+ */
+static uint64_t proximity_word_sse2(const double *x, const double *y, const double *z,
+                                    uint32_t first, uint32_t points,
+                                    double cx, double cy, double cz, double range_sq)
+{
+    const __m128d vcx = _mm_set1_pd(cx);
+    const __m128d vcy = _mm_set1_pd(cy);
+    const __m128d vcz = _mm_set1_pd(cz);
+    const __m128d vrange = _mm_set1_pd(range_sq);
+
+    uint64_t word = 0;
+    uint32_t i = 0;
+    for (; i + 2 <= points; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(&x[first + i]), vcx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(&y[first + i]), vcy);
+        __m128d dz = _mm_sub_pd(_mm_loadu_pd(&z[first + i]), vcz);
+        __m128d dist_sq = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)),
+                                     _mm_mul_pd(dz, dz));
+        // Ordered comparison: NaN distances compare false
+        uint64_t inside = (uint64_t)_mm_movemask_pd(_mm_cmple_pd(dist_sq, vrange));
+        word |= inside << i;
+    }
+    if (i < points) {
+        word |= proximity_word_scalar(x, y, z, first + i, points - i,
+                                      cx, cy, cz, range_sq) << i;
+    }
+    return word;
+}
+#endif
+
+/* ===== Proximity Mask ===== */
+
+uint32_t ble_gps_proximity_mask(const double *x,
+                                const double *y,
+                                const double *z,
+                                uint32_t count,
+                                const ble_gps_location_t *center,
+                                double range,
+                                uint64_t *mask)
+{
+    if (!mask) return 0;
+    if (!x || !y || !z || !center || !(range >= 0.0)) {
+        memset(mask, 0, BLE_GPS_MASK_WORDS(count) * sizeof(uint64_t));
+        return 0;
+    }
+
+    double range_sq = range * range;
+    uint32_t within = 0;
+    for (uint32_t first = 0, w = 0; first < count; first += BLE_GPS_MASK_WORD_BITS, w++) {
+        uint32_t points = count - first;
+        if (points > BLE_GPS_MASK_WORD_BITS) points = BLE_GPS_MASK_WORD_BITS;
+
+#ifdef BLE_GPS_PROXIMITY_SSE2
+        mask[w] = proximity_word_sse2(x, y, z, first, points,
+                                      center->x, center->y, center->z, range_sq);
+#else
+        mask[w] = proximity_word_scalar(x, y, z, first, points,
+                                        center->x, center->y, center->z, range_sq);
+#endif
+        within += popcount64(mask[w]);
+    }
+    return within;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file ble_gps_proximity.h
+ * @brief Pure C batched GPS proximity test for forwarding decisions
+ *
+ * GPS proximity filtering compares the last-hop GPS (LHGPS) of a message with
+ * the locations of many neighbors. This kernel tests a whole set of points
+ * at once: coordinates are given as one contiguous array per axis, distances
+ * are compared squared (no sqrt), and the result is a bitmask.
+ *
+ * On x86 with SSE2 two points are tested per instruction. Defining
+ * BLE_GPS_PROXIMITY_SCALAR (or building for a target without SSE2) selects a
+ * plain C loop that compilers can still auto-vectorize.
+ *
+ * Can be compiled without NS-3 or any C++ dependencies.
+ */
+
+#ifndef BLE_GPS_PROXIMITY_H
+#define BLE_GPS_PROXIMITY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_discovery_packet.h"
+
+/* ===== Constants ===== */
+
+#define BLE_GPS_MASK_WORD_BITS 64  /**< Points per mask word */
+
+/** Mask words needed for a number of points */
+#define BLE_GPS_MASK_WORDS(count) (((count) + BLE_GPS_MASK_WORD_BITS - 1) / BLE_GPS_MASK_WORD_BITS)
+
+/* ===== Function Prototypes ===== */
+
+/**
+ * @brief Mark the points within a distance of a center
+ *
+ * Bit (i % 64) of mask[i / 64] is set if point i is at most range away from
+ * center. Points with a NaN coordinate are never within range, so unknown
+ * locations can be stored as NaN.
+ *
+ * @param x X coordinates, count entries
+ * @param y Y coordinates, count entries
+ * @param z Z coordinates, count entries
+ * @param count Number of points
+ * @param center Location to measure from (e.g. the message's LHGPS)
+ * @param range Maximum distance, in the units of the coordinates
+ * @param mask Output, BLE_GPS_MASK_WORDS(count) words
+ * @return Number of points within range
+ */
+uint32_t ble_gps_proximity_mask(const double *x,
+                                const double *y,
+                                const double *z,
+                                uint32_t count,
+                                const ble_gps_location_t *center,
+                                double range,
+                                uint64_t *mask);
+
+/**
+ * @brief Check one point of a proximity mask
+ * @param mask Mask from ble_gps_proximity_mask()
+ * @param index Point index
+ * @return true if the point was within range
+ */
+static inline bool ble_gps_mask_test(const uint64_t *mask, uint32_t index)
+{
+    return (mask[index / BLE_GPS_MASK_WORD_BITS] >> (index % BLE_GPS_MASK_WORD_BITS)) & 1u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_GPS_PROXIMITY_H */
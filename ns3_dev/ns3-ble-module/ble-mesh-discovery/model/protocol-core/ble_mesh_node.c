@@ -7,6 +7,7 @@
 
 #include "ble_mesh_node.h"
 #include <string.h>
+#include <math.h>
 
 /* ===== Node Initialization ===== */
 
@@ -35,6 +36,11 @@ void ble_mesh_node_init(ble_mesh_node_t *node, uint32_t node_id)
     node->candidacy_score = 0.0;
     node->election_hash = ble_election_generate_hash(node_id);
 
+    node->wire_format = BLE_WIRE_FORMAT_LEGACY;
+
+    ble_dedup_init(&node->seen_messages, BLE_DEDUP_DEFAULT_EXPECTED,
+                   BLE_DEDUP_DEFAULT_FP_RATE, BLE_DEDUP_DEFAULT_MAX_AGE);
+
     node->current_cycle = 0;
 
     node->neighbors.count = 0;
@@ -204,55 +210,277 @@ void ble_mesh_node_advance_cycle(ble_mesh_node_t *node)
     if (!node) return;
     node->current_cycle++;
     node->stats.discovery_cycles++;
+    ble_dedup_advance_cycle(&node->seen_messages, node->current_cycle);
 }
 
 /* ===== Neighbor Management ===== */
 
-ble_neighbor_info_t* ble_mesh_node_find_neighbor(ble_mesh_node_t *node, uint32_t neighbor_id)
+#if BLE_MESH_MAX_NEIGHBORS >= 255 || BLE_MESH_NEIGHBOR_INDEX_SIZE <= BLE_MESH_MAX_NEIGHBORS
+#error "Neighbor index slots must exceed the table size, which must fit in uint8_t"
+#endif
+
+#if (BLE_MESH_NEIGHBOR_INDEX_SIZE & (BLE_MESH_NEIGHBOR_INDEX_SIZE - 1)) != 0
+#error "BLE_MESH_NEIGHBOR_INDEX_SIZE must be a power of two"
+#endif
+
+#define NEIGHBOR_INDEX_MASK (BLE_MESH_NEIGHBOR_INDEX_SIZE - 1)
+
+/*
+ * Field access by table position, for either layout. Everything below goes
+ * through these, so only they know how neighbors are stored.
+ */
+#ifdef BLE_MESH_COMPACT_NEIGHBORS
+
+#define NEIGHBOR_ID(table, i) ((table)->node_id[i])
+#define NEIGHBOR_RSSI(table, i) ((table)->rssi[i])
+#define NEIGHBOR_HOP_COUNT(table, i) ((table)->hop_count[i])
+#define NEIGHBOR_LAST_SEEN(table, i) ((table)->last_seen_cycle[i])
+#define NEIGHBOR_GPS_VALID(table, i) (((table)->flags[i] & BLE_NEIGHBOR_FLAG_GPS_VALID) != 0)
+
+/**
+ * @brief Quantize a GPS coordinate, saturating at the int32_t range
+ */
+static int32_t neighbor_quantize(double value)
 {
-    if (!node) return NULL;
+    double scaled = floor(value * BLE_NEIGHBOR_GPS_SCALE + 0.5);
+    if (scaled > (double)INT32_MAX) return INT32_MAX;
+    if (scaled < (double)INT32_MIN) return INT32_MIN;
+    return (int32_t)scaled;
+}
+
+static void neighbor_set_gps(ble_neighbor_table_t *table, uint16_t i,
+                             const ble_gps_location_t *gps)
+{
+    table->gps[i][0] = neighbor_quantize(gps->x);
+    table->gps[i][1] = neighbor_quantize(gps->y);
+    table->gps[i][2] = neighbor_quantize(gps->z);
+    table->flags[i] |= BLE_NEIGHBOR_FLAG_GPS_VALID;
+}
+
+static void neighbor_load(const ble_neighbor_table_t *table, uint16_t i,
+                          ble_neighbor_info_t *neighbor)
+{
+    neighbor->node_id = table->node_id[i];
+    neighbor->last_seen_cycle = table->last_seen_cycle[i];
+    neighbor->gps.x = table->gps[i][0] / BLE_NEIGHBOR_GPS_SCALE;
+    neighbor->gps.y = table->gps[i][1] / BLE_NEIGHBOR_GPS_SCALE;
+    neighbor->gps.z = table->gps[i][2] / BLE_NEIGHBOR_GPS_SCALE;
+    neighbor->clusterhead_class = table->clusterhead_class[i];
+    neighbor->rssi = table->rssi[i];
+    neighbor->hop_count = table->hop_count[i];
+    neighbor->is_clusterhead = (table->flags[i] & BLE_NEIGHBOR_FLAG_CLUSTERHEAD) != 0;
+    neighbor->gps_valid = (table->flags[i] & BLE_NEIGHBOR_FLAG_GPS_VALID) != 0;
+}
 
-    for (uint16_t i = 0; i < node->neighbors.count; i++) {
-        if (node->neighbors.neighbors[i].node_id == neighbor_id) {
-            return &node->neighbors.neighbors[i];
+static void neighbor_move(ble_neighbor_table_t *table, uint16_t to, uint16_t from)
+{
+    table->node_id[to] = table->node_id[from];
+    table->last_seen_cycle[to] = table->last_seen_cycle[from];
+    memcpy(table->gps[to], table->gps[from], sizeof(table->gps[0]));
+    table->clusterhead_class[to] = table->clusterhead_class[from];
+    table->rssi[to] = table->rssi[from];
+    table->hop_count[to] = table->hop_count[from];
+    table->flags[to] = table->flags[from];
+}
+
+static void neighbor_store_new(ble_neighbor_table_t *table, uint16_t i, uint32_t neighbor_id,
+                               int8_t rssi, uint8_t hop_count, uint32_t cycle)
+{
+    table->node_id[i] = neighbor_id;
+    table->last_seen_cycle[i] = cycle;
+    memset(table->gps[i], 0, sizeof(table->gps[0]));
+    table->clusterhead_class[i] = 0;
+    table->rssi[i] = rssi;
+    table->hop_count[i] = hop_count;
+    table->flags[i] = 0;
+}
+
+#else
+
+#define NEIGHBOR_ID(table, i) ((table)->neighbors[i].node_id)
+#define NEIGHBOR_RSSI(table, i) ((table)->neighbors[i].rssi)
+#define NEIGHBOR_HOP_COUNT(table, i) ((table)->neighbors[i].hop_count)
+#define NEIGHBOR_LAST_SEEN(table, i) ((table)->neighbors[i].last_seen_cycle)
+#define NEIGHBOR_GPS_VALID(table, i) ((table)->neighbors[i].gps_valid)
+
+static void neighbor_set_gps(ble_neighbor_table_t *table, uint16_t i,
+                             const ble_gps_location_t *gps)
+{
+    table->neighbors[i].gps = *gps;
+    table->neighbors[i].gps_valid = true;
+}
+
+static void neighbor_load(const ble_neighbor_table_t *table, uint16_t i,
+                          ble_neighbor_info_t *neighbor)
+{
+    *neighbor = table->neighbors[i];
+}
+
+static void neighbor_move(ble_neighbor_table_t *table, uint16_t to, uint16_t from)
+{
+    table->neighbors[to] = table->neighbors[from];
+}
+
+static void neighbor_store_new(ble_neighbor_table_t *table, uint16_t i, uint32_t neighbor_id,
+                               int8_t rssi, uint8_t hop_count, uint32_t cycle)
+{
+    ble_neighbor_info_t *neighbor = &table->neighbors[i];
+    memset(neighbor, 0, sizeof(*neighbor));
+    neighbor->node_id = neighbor_id;
+    neighbor->rssi = rssi;
+    neighbor->hop_count = hop_count;
+    neighbor->last_seen_cycle = cycle;
+}
+
+#endif /* BLE_MESH_COMPACT_NEIGHBORS */
+
+/**
+ * @brief Home slot of a node ID in the neighbor index (Fibonacci hashing)
+ */
+static inline uint16_t neighbor_index_slot(uint32_t neighbor_id)
+{
+    return (uint16_t)((neighbor_id * 2654435769u) >> 24) & NEIGHBOR_INDEX_MASK;
+}
+
+/**
+ * @brief Index the neighbor stored at a position of the table
+ */
+static void neighbor_index_insert(ble_neighbor_table_t *table, uint16_t position)
+{
+    uint16_t slot = neighbor_index_slot(NEIGHBOR_ID(table, position));
+    while (table->index[slot] != 0) {
+        slot = (slot + 1) & NEIGHBOR_INDEX_MASK;
+    }
+    table->index[slot] = (uint8_t)(position + 1);
+}
+
+/**
+ * @brief Rebuild the index after neighbors were moved
+ */
+static void neighbor_index_rebuild(ble_neighbor_table_t *table)
+{
+    memset(table->index, 0, sizeof(table->index));
+    for (uint16_t i = 0; i < table->count; i++) {
+        neighbor_index_insert(table, i);
+    }
+}
+
+/**
+ * @brief Table position of a neighbor, or -1 if unknown
+ */
+static int neighbor_find_position(const ble_neighbor_table_t *table, uint32_t neighbor_id)
+{
+    uint16_t slot = neighbor_index_slot(neighbor_id);
+    while (table->index[slot] != 0) {
+        uint16_t position = (uint16_t)(table->index[slot] - 1);
+        if (NEIGHBOR_ID(table, position) == neighbor_id) {
+            return position;
         }
+        slot = (slot + 1) & NEIGHBOR_INDEX_MASK;
     }
-    return NULL;
+    return -1;
 }
 
-bool ble_mesh_node_add_neighbor(ble_mesh_node_t *node,
-                                  uint32_t neighbor_id,
-                                  int8_t rssi,
-                                  uint8_t hop_count)
+ble_neighbor_info_t* ble_mesh_node_find_neighbor(ble_mesh_node_t *node, uint32_t neighbor_id)
 {
-    if (!node) return false;
+    if (!node) return NULL;
+
+    int position = neighbor_find_position(&node->neighbors, neighbor_id);
+    if (position < 0) return NULL;
+
+#ifdef BLE_MESH_COMPACT_NEIGHBORS
+    neighbor_load(&node->neighbors, (uint16_t)position, &node->neighbors.found);
+    return &node->neighbors.found;
+#else
+    return &node->neighbors.neighbors[position];
+#endif
+}
+
+bool ble_mesh_node_get_neighbor(const ble_mesh_node_t *node,
+                                  uint16_t position,
+                                  ble_neighbor_info_t *neighbor)
+{
+    if (!node || !neighbor || position >= node->neighbors.count) return false;
+
+    neighbor_load(&node->neighbors, position, neighbor);
+    return true;
+}
+
+/**
+ * @brief Add or update a neighbor, keeping the aggregates
+ * @return Table position of the neighbor, or -1 if the table is full
+ */
+static int neighbor_observe(ble_mesh_node_t *node, uint32_t neighbor_id,
+                            int8_t rssi, uint8_t hop_count)
+{
+    ble_neighbor_table_t *table = &node->neighbors;
 
     // Check if neighbor already exists
-    ble_neighbor_info_t *existing = ble_mesh_node_find_neighbor(node, neighbor_id);
-    if (existing) {
+    int existing = neighbor_find_position(table, neighbor_id);
+    if (existing >= 0) {
         // Update existing neighbor
-        existing->rssi = rssi;
-        existing->hop_count = hop_count;
-        existing->last_seen_cycle = node->current_cycle;
-        return true;
+        table->rssi_sum += rssi - NEIGHBOR_RSSI(table, existing);
+        table->direct_count += (hop_count == 1) - (NEIGHBOR_HOP_COUNT(table, existing) == 1);
+        NEIGHBOR_RSSI(table, existing) = rssi;
+        NEIGHBOR_HOP_COUNT(table, existing) = hop_count;
+        NEIGHBOR_LAST_SEEN(table, existing) = node->current_cycle;
+        return existing;
     }
 
     // Add new neighbor if space available
-    if (node->neighbors.count >= BLE_MESH_MAX_NEIGHBORS) {
-        return false; // Table full
+    if (table->count >= BLE_MESH_MAX_NEIGHBORS) {
+        return -1; // Table full
     }
 
-    ble_neighbor_info_t *new_neighbor = &node->neighbors.neighbors[node->neighbors.count];
-    new_neighbor->node_id = neighbor_id;
-    new_neighbor->rssi = rssi;
-    new_neighbor->hop_count = hop_count;
-    new_neighbor->last_seen_cycle = node->current_cycle;
-    new_neighbor->is_clusterhead = false;
-    new_neighbor->clusterhead_class = 0;
-    new_neighbor->gps_valid = false;
+    uint16_t position = table->count;
+    neighbor_store_new(table, position, neighbor_id, rssi, hop_count, node->current_cycle);
+    neighbor_index_insert(table, position);
+    table->count++;
+    table->rssi_sum += rssi;
+    table->direct_count += (hop_count == 1);
+    return position;
+}
 
-    node->neighbors.count++;
-    return true;
+/**
+ * @brief Set the GPS location of the neighbor at a position, keeping the aggregates
+ */
+static void neighbor_observe_gps(ble_neighbor_table_t *table, uint16_t position,
+                                 const ble_gps_location_t *gps)
+{
+    if (!NEIGHBOR_GPS_VALID(table, position)) {
+        table->gps_valid_count++;
+    }
+    neighbor_set_gps(table, position, gps);
+}
+
+bool ble_mesh_node_add_neighbor(ble_mesh_node_t *node,
+                                  uint32_t neighbor_id,
+                                  int8_t rssi,
+                                  uint8_t hop_count)
+{
+    if (!node) return false;
+    return neighbor_observe(node, neighbor_id, rssi, hop_count) >= 0;
+}
+
+uint16_t ble_mesh_node_add_neighbors(ble_mesh_node_t *node,
+                                       const ble_neighbor_observation_t *observations,
+                                       uint16_t count)
+{
+    if (!node || !observations) return 0;
+
+    uint16_t stored = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        const ble_neighbor_observation_t *observation = &observations[i];
+        int position = neighbor_observe(node, observation->node_id,
+                                        observation->rssi, observation->hop_count);
+        if (position < 0) continue;
+
+        if (observation->gps_valid) {
+            neighbor_observe_gps(&node->neighbors, (uint16_t)position, &observation->gps);
+        }
+        stored++;
+    }
+    return stored;
 }
 
 bool ble_mesh_node_update_neighbor_gps(ble_mesh_node_t *node,
@@ -261,61 +489,98 @@ bool ble_mesh_node_update_neighbor_gps(ble_mesh_node_t *node,
 {
     if (!node || !gps) return false;
 
-    ble_neighbor_info_t *neighbor = ble_mesh_node_find_neighbor(node, neighbor_id);
-    if (!neighbor) return false;
+    int position = neighbor_find_position(&node->neighbors, neighbor_id);
+    if (position < 0) return false;
 
-    neighbor->gps = *gps;
-    neighbor->gps_valid = true;
+    neighbor_observe_gps(&node->neighbors, (uint16_t)position, gps);
     return true;
 }
 
 uint16_t ble_mesh_node_count_direct_neighbors(const ble_mesh_node_t *node)
 {
     if (!node) return 0;
+    return node->neighbors.direct_count;
+}
+
+uint16_t ble_mesh_node_count_gps_neighbors(const ble_mesh_node_t *node)
+{
+    if (!node) return 0;
+    return node->neighbors.gps_valid_count;
+}
+
+uint16_t ble_mesh_node_neighbors_in_range(const ble_mesh_node_t *node,
+                                            const ble_gps_location_t *center,
+                                            double range,
+                                            uint64_t *mask)
+{
+    if (!mask) return 0;
+    if (!node || !center) {
+        memset(mask, 0, BLE_GPS_MASK_WORDS(BLE_MESH_MAX_NEIGHBORS) * sizeof(uint64_t));
+        return 0;
+    }
 
-    uint16_t count = 0;
-    for (uint16_t i = 0; i < node->neighbors.count; i++) {
-        if (node->neighbors.neighbors[i].hop_count == 1) {
-            count++;
+    // Gather the coordinates into one array per axis; NaN keeps neighbors
+    // without GPS out of range
+    const ble_neighbor_table_t *table = &node->neighbors;
+    double x[BLE_MESH_MAX_NEIGHBORS];
+    double y[BLE_MESH_MAX_NEIGHBORS];
+    double z[BLE_MESH_MAX_NEIGHBORS];
+    for (uint16_t i = 0; i < table->count; i++) {
+        if (!NEIGHBOR_GPS_VALID(table, i)) {
+            x[i] = y[i] = z[i] = NAN;
+            continue;
         }
+#ifdef BLE_MESH_COMPACT_NEIGHBORS
+        x[i] = table->gps[i][0] / BLE_NEIGHBOR_GPS_SCALE;
+        y[i] = table->gps[i][1] / BLE_NEIGHBOR_GPS_SCALE;
+        z[i] = table->gps[i][2] / BLE_NEIGHBOR_GPS_SCALE;
+#else
+        x[i] = table->neighbors[i].gps.x;
+        y[i] = table->neighbors[i].gps.y;
+        z[i] = table->neighbors[i].gps.z;
+#endif
     }
-    return count;
+
+    memset(mask, 0, BLE_GPS_MASK_WORDS(BLE_MESH_MAX_NEIGHBORS) * sizeof(uint64_t));
+    return (uint16_t)ble_gps_proximity_mask(x, y, z, table->count, center, range, mask);
 }
 
 int8_t ble_mesh_node_calculate_avg_rssi(const ble_mesh_node_t *node)
 {
     if (!node || node->neighbors.count == 0) return 0;
-
-    int32_t sum = 0;
-    for (uint16_t i = 0; i < node->neighbors.count; i++) {
-        sum += node->neighbors.neighbors[i].rssi;
-    }
-    return (int8_t)(sum / node->neighbors.count);
+    return (int8_t)(node->neighbors.rssi_sum / node->neighbors.count);
 }
 
 uint16_t ble_mesh_node_prune_stale_neighbors(ble_mesh_node_t *node, uint32_t max_age)
 {
     if (!node) return 0;
 
+    ble_neighbor_table_t *table = &node->neighbors;
     uint16_t removed = 0;
     uint16_t write_idx = 0;
 
-    for (uint16_t read_idx = 0; read_idx < node->neighbors.count; read_idx++) {
-        uint32_t age = node->current_cycle - node->neighbors.neighbors[read_idx].last_seen_cycle;
+    for (uint16_t read_idx = 0; read_idx < table->count; read_idx++) {
+        uint32_t age = node->current_cycle - NEIGHBOR_LAST_SEEN(table, read_idx);
 
         if (age <= max_age) {
             // Keep this neighbor
             if (write_idx != read_idx) {
-                node->neighbors.neighbors[write_idx] = node->neighbors.neighbors[read_idx];
+                neighbor_move(table, write_idx, read_idx);
             }
             write_idx++;
         } else {
             // Remove (don't copy)
+            table->rssi_sum -= NEIGHBOR_RSSI(table, read_idx);
+            table->direct_count -= (NEIGHBOR_HOP_COUNT(table, read_idx) == 1);
+            table->gps_valid_count -= NEIGHBOR_GPS_VALID(table, read_idx);
             removed++;
         }
     }
 
-    node->neighbors.count = write_idx;
+    table->count = write_idx;
+    if (removed > 0) {
+        neighbor_index_rebuild(table);
+    }
     return removed;
 }
 
@@ -363,6 +628,12 @@ bool ble_mesh_node_should_become_candidate(const ble_mesh_node_t *node)
             avg_rssi >= BLE_MESH_EDGE_RSSI_THRESHOLD);
 }
 
+void ble_mesh_node_append_pdsf(const ble_mesh_node_t *node, ble_election_data_t *election)
+{
+    if (!node || !election) return;
+    ble_election_append_pdsf(election, ble_mesh_node_count_direct_neighbors(node));
+}
+
 /* ===== Statistics ===== */
 
 void ble_mesh_node_update_statistics(ble_mesh_node_t *node)
@@ -396,3 +667,63 @@ void ble_mesh_node_inc_dropped(ble_mesh_node_t *node)
     if (!node) return;
     node->stats.messages_dropped++;
 }
+
+/* ===== Duplicate Suppression ===== */
+
+bool ble_mesh_node_configure_dedup(ble_mesh_node_t *node,
+                                     uint32_t expected_messages,
+                                     double false_positive_rate,
+                                     uint32_t max_age_cycles)
+{
+    if (!node) return false;
+    if (!ble_dedup_init(&node->seen_messages, expected_messages,
+                        false_positive_rate, max_age_cycles)) {
+        return false;
+    }
+    ble_dedup_clear(&node->seen_messages, node->current_cycle);
+    return true;
+}
+
+bool ble_mesh_node_is_duplicate(ble_mesh_node_t *node,
+                                  uint32_t sender_id,
+                                  uint32_t sequence)
+{
+    if (!node) return false;
+    return ble_dedup_check_and_insert(&node->seen_messages, sender_id, sequence);
+}
+
+/* ===== Forwarding ===== */
+
+bool ble_mesh_node_queue_forward(ble_mesh_node_t *node, ble_forward_queue_t *queue,
+                                 const ble_discovery_packet_t *packet)
+{
+    if (!node || !queue || !packet) return false;
+
+    uint32_t evicted = queue->evicted;
+    bool queued = ble_forward_queue_push(queue, packet);
+    node->stats.messages_dropped += queue->evicted - evicted;
+    if (!queued) {
+        node->stats.messages_dropped++;
+    }
+    return queued;
+}
+
+uint16_t ble_mesh_node_select_forwards(ble_forward_queue_t *queue, ble_discovery_packet_t *packets)
+{
+    if (!queue) return 0;
+    return ble_forward_queue_pop_top(queue, packets, BLE_FORWARD_SLOTS_PER_CYCLE);
+}
+
+/* ===== Encoding ===== */
+
+void ble_mesh_node_set_wire_format(ble_mesh_node_t *node, ble_wire_format_t format)
+{
+    if (!node) return;
+    node->wire_format = format;
+}
+
+ble_wire_format_t ble_mesh_node_get_wire_format(const ble_mesh_node_t *node)
+{
+    if (!node) return BLE_WIRE_FORMAT_LEGACY;
+    return node->wire_format;
+}
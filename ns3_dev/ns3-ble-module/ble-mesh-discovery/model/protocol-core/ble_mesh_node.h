@@ -20,14 +20,47 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 #include "ble_discovery_packet.h"
+#include "ble_dedup_cache.h"
+#include "ble_forward_queue.h"
+#include "ble_gps_proximity.h"
 
 /* ===== Constants ===== */
 
-#define BLE_MESH_MAX_NEIGHBORS 150      /**< Maximum neighbors per node */
 #define BLE_MESH_INVALID_NODE_ID 0      /**< Invalid/unassigned node ID */
 #define BLE_MESH_DISCOVERY_TIMEOUT 30   /**< Discovery phase timeout in cycles */
 #define BLE_MESH_EDGE_RSSI_THRESHOLD -70 /**< RSSI threshold for edge detection (dBm) */
 
+/* ===== Neighbor Table Configuration ===== */
+
+/*
+ * These may be defined on the compiler command line, and must then be the
+ * same for every file that includes this header (C core and wrapper alike).
+ *
+ * BLE_MESH_MAX_NEIGHBORS         Table capacity (at most 254)
+ * BLE_MESH_NEIGHBOR_INDEX_SIZE   Hash index slots (power of two, > capacity)
+ * BLE_MESH_COMPACT_NEIGHBORS     Store neighbors as columns, with GPS in
+ *                                centimeters and packed flags (25 bytes per
+ *                                neighbor instead of 40)
+ */
+
+#ifndef BLE_MESH_MAX_NEIGHBORS
+#define BLE_MESH_MAX_NEIGHBORS 150      /**< Maximum neighbors per node */
+#endif
+
+#ifndef BLE_MESH_NEIGHBOR_INDEX_SIZE
+#if BLE_MESH_MAX_NEIGHBORS <= 40
+#define BLE_MESH_NEIGHBOR_INDEX_SIZE 64
+#elif BLE_MESH_MAX_NEIGHBORS <= 80
+#define BLE_MESH_NEIGHBOR_INDEX_SIZE 128
+#else
+#define BLE_MESH_NEIGHBOR_INDEX_SIZE 256 /**< Hash index slots (power of two, > neighbors) */
+#endif
+#endif
+
+#define BLE_NEIGHBOR_FLAG_CLUSTERHEAD 0x01 /**< Compact layout: is_clusterhead */
+#define BLE_NEIGHBOR_FLAG_GPS_VALID 0x02   /**< Compact layout: gps_valid */
+#define BLE_NEIGHBOR_GPS_SCALE 100.0       /**< Compact layout: GPS steps per meter (1 cm) */
+
 /* ===== Node State Enumeration ===== */
 
 /**
@@ -52,23 +85,59 @@ typedef enum {
  */
 typedef struct {
     uint32_t node_id;           /**< Neighbor's node ID */
+    uint32_t last_seen_cycle;   /**< Last discovery cycle when heard from */
+    ble_gps_location_t gps;     /**< Neighbor's GPS location */
+    uint16_t clusterhead_class; /**< Clusterhead class if applicable */
     int8_t rssi;                /**< RSSI value (dBm) */
     uint8_t hop_count;          /**< Hop count to this neighbor */
-    uint32_t last_seen_cycle;   /**< Last discovery cycle when heard from */
     bool is_clusterhead;        /**< Whether neighbor is a clusterhead */
-    uint16_t clusterhead_class; /**< Clusterhead class if applicable */
-    ble_gps_location_t gps;     /**< Neighbor's GPS location */
     bool gps_valid;             /**< Whether GPS location is valid */
 } ble_neighbor_info_t;
 
+/**
+ * @brief One reception from a neighbor, for batch ingestion
+ */
+typedef struct {
+    uint32_t node_id;           /**< Neighbor's node ID */
+    ble_gps_location_t gps;     /**< Neighbor's GPS location (if gps_valid) */
+    int8_t rssi;                /**< RSSI value (dBm) */
+    uint8_t hop_count;          /**< Hop count to this neighbor */
+    bool gps_valid;             /**< Whether the reception carried a GPS location */
+} ble_neighbor_observation_t;
+
 /* ===== Neighbor Table Structure ===== */
 
 /**
  * @brief Neighbor tracking table
+ *
+ * Neighbors are stored densely at positions [0..count). An open-addressing
+ * hash index over node_id (linear probing, at most 59% full) finds them in
+ * O(1) on average. Each index slot holds a position plus one, or 0 if empty.
+ *
+ * The aggregates used by the election decisions are kept up to date by the
+ * neighbor functions, so entries must not be modified directly. Read them
+ * with ble_mesh_node_get_neighbor(), which works with either layout.
  */
 typedef struct {
+#ifdef BLE_MESH_COMPACT_NEIGHBORS
+    uint32_t node_id[BLE_MESH_MAX_NEIGHBORS];         /**< Neighbor node IDs */
+    uint32_t last_seen_cycle[BLE_MESH_MAX_NEIGHBORS]; /**< Last cycle heard from */
+    int32_t gps[BLE_MESH_MAX_NEIGHBORS][3];           /**< GPS in 1/BLE_NEIGHBOR_GPS_SCALE m */
+    uint16_t clusterhead_class[BLE_MESH_MAX_NEIGHBORS]; /**< Clusterhead classes */
+    int8_t rssi[BLE_MESH_MAX_NEIGHBORS];              /**< RSSI values (dBm) */
+    uint8_t hop_count[BLE_MESH_MAX_NEIGHBORS];        /**< Hop counts */
+    uint8_t flags[BLE_MESH_MAX_NEIGHBORS];            /**< BLE_NEIGHBOR_FLAG_* bits */
+    ble_neighbor_info_t found;  /**< Decoded result of the last find_neighbor */
+#else
     ble_neighbor_info_t neighbors[BLE_MESH_MAX_NEIGHBORS];
+#endif
     uint16_t count;             /**< Current number of neighbors */
+    uint8_t index[BLE_MESH_NEIGHBOR_INDEX_SIZE]; /**< node_id hash index */
+
+    /* Aggregates */
+    uint16_t direct_count;      /**< Neighbors with hop_count 1 */
+    uint16_t gps_valid_count;   /**< Neighbors with a valid GPS location */
+    int32_t rssi_sum;           /**< Sum of neighbor RSSI values (dBm) */
 } ble_neighbor_table_t;
 
 /* ===== Node Statistics Structure ===== */
@@ -116,6 +185,12 @@ typedef struct {
     double candidacy_score;         /**< Clusterhead candidacy score (0.0-1.0) */
     uint32_t election_hash;         /**< FDMA/TDMA hash value */
 
+    /* Encoding */
+    ble_wire_format_t wire_format;  /**< Wire format of transmitted packets */
+
+    /* Duplicate suppression */
+    ble_dedup_cache_t seen_messages; /**< Recently seen (sender, sequence) pairs */
+
     /* Timing */
     uint32_t current_cycle;         /**< Current discovery cycle number */
 
@@ -136,9 +211,9 @@ void ble_mesh_node_init(ble_mesh_node_t *node, uint32_t node_id);
 /**
  * @brief Set node GPS location
  * @param node Pointer to node structure
- * @param x GPS X coordinate (latitude)
- * @param y GPS Y coordinate (longitude)
- * @param z GPS Z coordinate (altitude)
+ * @param x GPS X coordinate (m)
+ * @param y GPS Y coordinate (m)
+ * @param z GPS Z coordinate, height (m)
  */
 void ble_mesh_node_set_gps(ble_mesh_node_t *node, double x, double y, double z);
 
@@ -224,6 +299,23 @@ bool ble_mesh_node_add_neighbor(ble_mesh_node_t *node,
                                   int8_t rssi,
                                   uint8_t hop_count);
 
+/**
+ * @brief Add or update neighbors from a batch of receptions
+ *
+ * Equivalent to ble_mesh_node_add_neighbor() for each observation in order,
+ * followed by ble_mesh_node_update_neighbor_gps() when it carries a GPS
+ * location. Repeated neighbors in the batch are merged into one entry (the
+ * last reception wins), and the aggregates are updated in the same pass.
+ *
+ * @param node Pointer to node structure
+ * @param observations Receptions, in arrival order
+ * @param count Number of observations
+ * @return Number of observations stored (the rest found the table full)
+ */
+uint16_t ble_mesh_node_add_neighbors(ble_mesh_node_t *node,
+                                       const ble_neighbor_observation_t *observations,
+                                       uint16_t count);
+
 /**
  * @brief Update neighbor's GPS location
  * @param node Pointer to node structure
@@ -237,6 +329,10 @@ bool ble_mesh_node_update_neighbor_gps(ble_mesh_node_t *node,
 
 /**
  * @brief Find a neighbor by ID
+ *
+ * With BLE_MESH_COMPACT_NEIGHBORS the result is a decoded copy, which the
+ * next lookup overwrites and whose modification has no effect.
+ *
  * @param node Pointer to node structure
  * @param neighbor_id Neighbor's node ID
  * @return Pointer to neighbor info, or NULL if not found
@@ -244,6 +340,17 @@ bool ble_mesh_node_update_neighbor_gps(ble_mesh_node_t *node,
 ble_neighbor_info_t* ble_mesh_node_find_neighbor(ble_mesh_node_t *node,
                                                    uint32_t neighbor_id);
 
+/**
+ * @brief Copy out the neighbor at a table position
+ * @param node Pointer to node structure
+ * @param position Position in the table, below neighbors.count
+ * @param neighbor Output neighbor info
+ * @return false if the position is out of range
+ */
+bool ble_mesh_node_get_neighbor(const ble_mesh_node_t *node,
+                                  uint16_t position,
+                                  ble_neighbor_info_t *neighbor);
+
 /**
  * @brief Count direct (1-hop) neighbors
  * @param node Pointer to node structure
@@ -251,6 +358,31 @@ ble_neighbor_info_t* ble_mesh_node_find_neighbor(ble_mesh_node_t *node,
  */
 uint16_t ble_mesh_node_count_direct_neighbors(const ble_mesh_node_t *node);
 
+/**
+ * @brief Count neighbors with a valid GPS location
+ * @param node Pointer to node structure
+ * @return Number of neighbors with GPS
+ */
+uint16_t ble_mesh_node_count_gps_neighbors(const ble_mesh_node_t *node);
+
+/**
+ * @brief Find the neighbors within a distance of a location
+ *
+ * Runs ble_gps_proximity_mask() over the neighbor table. Bit i of the mask
+ * refers to table position i (see ble_mesh_node_get_neighbor()); neighbors
+ * without a valid GPS location are never marked.
+ *
+ * @param node Pointer to node structure
+ * @param center Location to measure from (e.g. a message's LHGPS)
+ * @param range Maximum distance in meters
+ * @param mask Output, BLE_GPS_MASK_WORDS(BLE_MESH_MAX_NEIGHBORS) words
+ * @return Number of neighbors within range
+ */
+uint16_t ble_mesh_node_neighbors_in_range(const ble_mesh_node_t *node,
+                                            const ble_gps_location_t *center,
+                                            double range,
+                                            uint64_t *mask);
+
 /**
  * @brief Calculate average RSSI of all neighbors
  * @param node Pointer to node structure
@@ -277,6 +409,17 @@ double ble_mesh_node_calculate_candidacy_score(const ble_mesh_node_t *node,
                                                  double noise_level,
                                                  double geographic_distribution);
 
+/**
+ * @brief Append this node's direct count to a received election announcement
+ *
+ * O(1): uses the running direct-neighbor count and the PDSF product carried
+ * in the announcement.
+ *
+ * @param node Pointer to node structure
+ * @param election Election fields of the announcement being forwarded
+ */
+void ble_mesh_node_append_pdsf(const ble_mesh_node_t *node, ble_election_data_t *election);
+
 /**
  * @brief Update node statistics
  * @param node Pointer to node structure
@@ -321,6 +464,72 @@ void ble_mesh_node_inc_forwarded(ble_mesh_node_t *node);
  */
 void ble_mesh_node_inc_dropped(ble_mesh_node_t *node);
 
+/**
+ * @brief Configure the duplicate-suppression cache (forgets seen messages)
+ * @param node Pointer to node structure
+ * @param expected_messages Distinct messages expected per cache generation
+ * @param false_positive_rate Target false-positive rate, in (0.0, 1.0)
+ * @param max_age_cycles Discovery cycles per cache generation
+ * @return false if a parameter is invalid
+ */
+bool ble_mesh_node_configure_dedup(ble_mesh_node_t *node,
+                                     uint32_t expected_messages,
+                                     double false_positive_rate,
+                                     uint32_t max_age_cycles);
+
+/**
+ * @brief Check if a message was already seen by this node, and record it
+ *
+ * The packet format has no sequence number, so the caller identifies each
+ * message of an originator (e.g. by the cycle in which it was sent).
+ *
+ * @param node Pointer to node structure
+ * @param sender_id Originator of the message
+ * @param sequence Sequence number of the message at its originator
+ * @return true if the message is a duplicate (or a false positive)
+ */
+bool ble_mesh_node_is_duplicate(ble_mesh_node_t *node,
+                                  uint32_t sender_id,
+                                  uint32_t sequence);
+
+/**
+ * @brief Queue a received message for forwarding
+ *
+ * The queue is owned by the caller rather than embedded in the node, so
+ * nodes that never relay do not pay for it. Messages refused by the queue,
+ * or evicted from it by a message with a higher TTL, are counted as dropped
+ * by the node.
+ *
+ * @param node Pointer to node structure
+ * @param queue Forwarding queue of the node
+ * @param packet Message that passed the forwarding filters
+ * @return true if the message was queued
+ */
+bool ble_mesh_node_queue_forward(ble_mesh_node_t *node, ble_forward_queue_t *queue,
+                                 const ble_discovery_packet_t *packet);
+
+/**
+ * @brief Take the messages to forward in this discovery cycle
+ * @param queue Forwarding queue of the node
+ * @param packets Output array of BLE_FORWARD_SLOTS_PER_CYCLE messages
+ * @return Number of messages taken, highest TTL first
+ */
+uint16_t ble_mesh_node_select_forwards(ble_forward_queue_t *queue, ble_discovery_packet_t *packets);
+
+/**
+ * @brief Select the wire format of the packets this node transmits
+ * @param node Pointer to node structure
+ * @param format Wire format
+ */
+void ble_mesh_node_set_wire_format(ble_mesh_node_t *node, ble_wire_format_t format);
+
+/**
+ * @brief Get the wire format of the packets this node transmits
+ * @param node Pointer to node structure
+ * @return Wire format (BLE_WIRE_FORMAT_LEGACY by default)
+ */
+ble_wire_format_t ble_mesh_node_get_wire_format(const ble_mesh_node_t *node);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,211 @@
+/**
+ * @file ble-dedup-cache-c-test.c
+ * @brief Standalone C tests for the duplicate-suppression cache
+ *
+ * Pure C test suite for the rotating Bloom filter of seen messages
+ * Tests lookups, false-positive rate, aging, and parameter validation
+ */
+
+#include "../model/protocol-core/ble_dedup_cache.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Test counter */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (condition) { \
+            tests_passed++; \
+        } else { \
+            tests_failed++; \
+            printf("FAIL: %s (line %d): %s\n", __func__, __LINE__, message); \
+        } \
+    } while(0)
+
+/* ===== Test: Lookups ===== */
+
+void test_dedup_insert_and_contains(void)
+{
+    printf("Running test_dedup_insert_and_contains...\n");
+
+    ble_dedup_cache_t cache;
+    TEST_ASSERT(ble_dedup_init(&cache, BLE_DEDUP_DEFAULT_EXPECTED,
+                               BLE_DEDUP_DEFAULT_FP_RATE, BLE_DEDUP_DEFAULT_MAX_AGE),
+                "Default parameters should be valid");
+    TEST_ASSERT(!ble_dedup_contains(&cache, 10, 1), "Empty cache should contain nothing");
+
+    ble_dedup_insert(&cache, 10, 1);
+    TEST_ASSERT(ble_dedup_contains(&cache, 10, 1), "Inserted message should be found");
+    TEST_ASSERT(cache.inserted == 1, "Insert count should be 1");
+
+    // No false negatives for everything inserted
+    bool all_found = true;
+    for (uint32_t sender = 0; sender < 50; sender++) {
+        ble_dedup_insert(&cache, sender, sender * 7);
+    }
+    for (uint32_t sender = 0; sender < 50; sender++) {
+        all_found = all_found && ble_dedup_contains(&cache, sender, sender * 7);
+    }
+    TEST_ASSERT(all_found, "Every inserted message should be found");
+}
+
+void test_dedup_check_and_insert(void)
+{
+    printf("Running test_dedup_check_and_insert...\n");
+
+    ble_dedup_cache_t cache;
+    ble_dedup_init(&cache, 100, 0.01, 4);
+
+    TEST_ASSERT(!ble_dedup_check_and_insert(&cache, 5, 42), "First copy is not a duplicate");
+    TEST_ASSERT(ble_dedup_check_and_insert(&cache, 5, 42), "Second copy is a duplicate");
+    TEST_ASSERT(!ble_dedup_check_and_insert(&cache, 5, 43), "Next sequence is not a duplicate");
+    TEST_ASSERT(cache.inserted == 2, "Duplicates should not be counted as insertions");
+}
+
+/* ===== Test: False-Positive Rate ===== */
+
+void test_dedup_false_positive_rate(void)
+{
+    printf("Running test_dedup_false_positive_rate...\n");
+
+    const uint32_t expected = 150;
+    const double target = 0.01;
+    ble_dedup_cache_t cache;
+    ble_dedup_init(&cache, expected, target, 4);
+
+    for (uint32_t i = 0; i < expected; i++) {
+        ble_dedup_insert(&cache, 1000 + i, i);
+    }
+
+    // Probe messages that were never inserted
+    uint32_t probes = 20000;
+    uint32_t false_positives = 0;
+    for (uint32_t i = 0; i < probes; i++) {
+        if (ble_dedup_contains(&cache, 50000 + i, i)) {
+            false_positives++;
+        }
+    }
+    double measured = (double)false_positives / probes;
+    printf("  measured false-positive rate: %.4f (target %.4f, estimate %.4f)\n",
+           measured, target, ble_dedup_estimated_fp_rate(&cache));
+
+    TEST_ASSERT(measured <= 2.0 * target, "Measured rate should be close to the target");
+    TEST_ASSERT(ble_dedup_estimated_fp_rate(&cache) <= 2.0 * target,
+                "Estimated rate should be close to the target");
+}
+
+void test_dedup_size_limit(void)
+{
+    printf("Running test_dedup_size_limit...\n");
+
+    ble_dedup_cache_t cache;
+    TEST_ASSERT(ble_dedup_init(&cache, 100000, 0.001, 4), "Large sizes should be clamped");
+    TEST_ASSERT(cache.num_bits == BLE_DEDUP_MAX_BITS, "Bits should be limited");
+    TEST_ASSERT(cache.num_hashes >= 1 && cache.num_hashes <= BLE_DEDUP_MAX_HASHES,
+                "Hash count should be in range");
+}
+
+/* ===== Test: Aging ===== */
+
+void test_dedup_rotation(void)
+{
+    printf("Running test_dedup_rotation...\n");
+
+    ble_dedup_cache_t cache;
+    ble_dedup_init(&cache, 100, 0.01, 4);
+    ble_dedup_insert(&cache, 7, 1);
+
+    // Still remembered within the first generation
+    ble_dedup_advance_cycle(&cache, 3);
+    TEST_ASSERT(ble_dedup_contains(&cache, 7, 1), "Message should survive within its generation");
+
+    // After one rotation it moves to the previous generation
+    ble_dedup_advance_cycle(&cache, 4);
+    TEST_ASSERT(cache.generation_start == 4, "New generation should start at cycle 4");
+    TEST_ASSERT(ble_dedup_contains(&cache, 7, 1), "Message should survive one rotation");
+
+    // After a second rotation it is forgotten
+    ble_dedup_advance_cycle(&cache, 8);
+    TEST_ASSERT(!ble_dedup_contains(&cache, 7, 1), "Message should expire after two rotations");
+}
+
+void test_dedup_refresh_on_duplicate(void)
+{
+    printf("Running test_dedup_refresh_on_duplicate...\n");
+
+    ble_dedup_cache_t cache;
+    ble_dedup_init(&cache, 100, 0.01, 4);
+    ble_dedup_check_and_insert(&cache, 9, 2);
+
+    ble_dedup_advance_cycle(&cache, 4);
+    TEST_ASSERT(ble_dedup_check_and_insert(&cache, 9, 2),
+                "Copy from the previous generation should be a duplicate");
+
+    // The duplicate was recorded again, so it survives the next rotation
+    ble_dedup_advance_cycle(&cache, 8);
+    TEST_ASSERT(ble_dedup_contains(&cache, 9, 2), "Refreshed message should survive");
+}
+
+void test_dedup_long_gap_clears(void)
+{
+    printf("Running test_dedup_long_gap_clears...\n");
+
+    ble_dedup_cache_t cache;
+    ble_dedup_init(&cache, 100, 0.01, 4);
+    ble_dedup_insert(&cache, 3, 3);
+
+    ble_dedup_advance_cycle(&cache, 20);
+    TEST_ASSERT(!ble_dedup_contains(&cache, 3, 3), "Long gap should empty the cache");
+    TEST_ASSERT(cache.generation_start == 20, "Generation should restart at current cycle");
+    TEST_ASSERT(cache.inserted == 0, "Insert count should be reset");
+}
+
+/* ===== Test: Parameter Validation ===== */
+
+void test_dedup_invalid_parameters(void)
+{
+    printf("Running test_dedup_invalid_parameters...\n");
+
+    ble_dedup_cache_t cache;
+    ble_dedup_init(&cache, 100, 0.01, 4);
+
+    TEST_ASSERT(!ble_dedup_init(NULL, 100, 0.01, 4), "NULL cache should fail");
+    TEST_ASSERT(!ble_dedup_init(&cache, 0, 0.01, 4), "Zero expected messages should fail");
+    TEST_ASSERT(!ble_dedup_init(&cache, 100, 0.0, 4), "Zero rate should fail");
+    TEST_ASSERT(!ble_dedup_init(&cache, 100, 1.0, 4), "Rate of 1 should fail");
+    TEST_ASSERT(!ble_dedup_init(&cache, 100, 0.01, 0), "Zero max age should fail");
+    TEST_ASSERT(cache.max_age_cycles == 4, "Failed init should leave the cache unchanged");
+
+    TEST_ASSERT(!ble_dedup_contains(NULL, 1, 1), "NULL lookup should return false");
+    TEST_ASSERT(!ble_dedup_check_and_insert(NULL, 1, 1), "NULL check should return false");
+}
+
+/* ===== Main Test Runner ===== */
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("BLE Dedup Cache C Test Suite\n");
+    printf("========================================\n\n");
+
+    /* Run all tests */
+    test_dedup_insert_and_contains();
+    test_dedup_check_and_insert();
+    test_dedup_false_positive_rate();
+    test_dedup_size_limit();
+    test_dedup_rotation();
+    test_dedup_refresh_on_duplicate();
+    test_dedup_long_gap_clears();
+    test_dedup_invalid_parameters();
+
+    /* Print results */
+    printf("\n========================================\n");
+    printf("Test Results:\n");
+    printf("  PASSED: %d\n", tests_passed);
+    printf("  FAILED: %d\n", tests_failed);
+    printf("========================================\n");
+
+    return (tests_failed == 0) ? 0 : 1;
+}
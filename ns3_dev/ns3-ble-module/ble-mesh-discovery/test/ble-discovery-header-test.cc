@@ -14,6 +14,8 @@
 
 #include "ns3/test.h"
 #include "ns3/ble-discovery-header-wrapper.h"
+#include "ns3/ble-mesh-node-wrapper.h"
+#include "ns3/enum.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
 
@@ -262,6 +264,15 @@ BleDiscoveryElectionTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (msg.GetScore (), 0.95, "Score should be set");
   NS_TEST_ASSERT_MSG_EQ (msg.GetHash (), (uint32_t)0xABCDEF, "Hash should be set");
 
+  // Test: Forwarding nodes append their direct counts to the PDSF
+  BleDiscoveryHeaderWrapper forwarded;
+  forwarded.SetAsElectionMessage ();
+  forwarded.AppendPdsf (3);
+  forwarded.AppendPdsf (4);
+  forwarded.AppendPdsf (5);
+  NS_TEST_ASSERT_MSG_EQ (forwarded.GetPdsf (), 75u, "PDSF should be 3 + 3*4 + 3*4*5");
+  NS_TEST_ASSERT_MSG_EQ (forwarded.GetPdsfProduct (), 60u, "PDSF product should be 3*4*5");
+
   // Test: Election serialization size
   uint32_t electionSize = msg.GetSerializedSize ();
   NS_TEST_ASSERT_MSG_GT (electionSize, 50, "Election packet should be substantial size");
@@ -416,6 +427,123 @@ BleDiscoveryTypeIdTestCase::DoRun (void)
                          "Print should include election fields");
 }
 
+/**
+ * \ingroup ble-mesh-discovery-test
+ * \brief Compact Wire Format Test
+ */
+class BleDiscoveryWireFormatTestCase : public TestCase
+{
+public:
+  BleDiscoveryWireFormatTestCase ();
+  virtual ~BleDiscoveryWireFormatTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BleDiscoveryWireFormatTestCase::BleDiscoveryWireFormatTestCase ()
+  : TestCase ("BleDiscoveryHeader compact wire format test")
+{
+}
+
+BleDiscoveryWireFormatTestCase::~BleDiscoveryWireFormatTestCase ()
+{
+}
+
+void
+BleDiscoveryWireFormatTestCase::DoRun (void)
+{
+  // The node selects the format of the headers it sends
+  Ptr<BleMeshNodeWrapper> node = CreateObject<BleMeshNodeWrapper> ();
+  node->SetAttribute ("WireFormat", EnumValue (BLE_WIRE_FORMAT_COMPACT));
+  node->Initialize (1010);
+  NS_TEST_ASSERT_MSG_EQ (node->GetWireFormat (), BLE_WIRE_FORMAT_COMPACT,
+                         "Initialize should keep the wire format");
+
+  BleDiscoveryHeaderWrapper original;
+  original.SetSenderId (node->GetNodeId ());
+  original.SetTtl (0);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      original.AddToPath (1000 + i);
+    }
+  original.SetGpsLocation (Vector (120.25, 80.5, 1.5));
+  uint32_t legacySize = original.GetSerializedSize ();
+  original.SetWireFormat (node->GetWireFormat ());
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (original.GetSerializedSize (), 31,
+                               "Compact 10-hop header should fit in a legacy advertisement");
+  NS_TEST_ASSERT_MSG_LT (original.GetSerializedSize (), legacySize,
+                         "Compact header should be smaller than legacy");
+
+  Ptr<Packet> pkt = Create<Packet> (20);
+  pkt->AddHeader (original);
+  NS_TEST_ASSERT_MSG_EQ (pkt->GetSize (), original.GetSerializedSize () + 20,
+                         "Packet size should include compact header and payload");
+
+  // The receiver detects the format
+  BleDiscoveryHeaderWrapper copy;
+  pkt->RemoveHeader (copy);
+  NS_TEST_ASSERT_MSG_EQ (copy.GetWireFormat (), BLE_WIRE_FORMAT_COMPACT,
+                         "Compact format should be detected");
+  NS_TEST_ASSERT_MSG_EQ (pkt->GetSize (), 20, "Only the payload should remain");
+  NS_TEST_ASSERT_MSG_EQ (copy.IsElectionMessage (), false, "Should be a discovery message");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetSenderId (), 1010, "Sender ID should match");
+  NS_TEST_ASSERT_MSG_EQ ((copy.GetPath () == original.GetPath ()), true, "Path should match");
+  NS_TEST_ASSERT_MSG_EQ_TOL (copy.GetGpsLocation ().x, 120.25, 0.005, "GPS X should match");
+  NS_TEST_ASSERT_MSG_EQ_TOL (copy.GetGpsLocation ().y, 80.5, 0.005, "GPS Y should match");
+  NS_TEST_ASSERT_MSG_EQ_TOL (copy.GetGpsLocation ().z, 1.5, 0.005, "GPS Z should match");
+
+  // Election messages
+  BleDiscoveryHeaderWrapper election;
+  election.SetWireFormat (BLE_WIRE_FORMAT_COMPACT);
+  election.SetSenderId (7);
+  election.AddToPath (7);
+  election.SetClassId (3);
+  election.SetPdsf (149);
+  election.SetScore (0.5);
+  election.SetHash (0xCAFEBABE);
+  pkt = Create<Packet> ();
+  pkt->AddHeader (election);
+
+  BleDiscoveryHeaderWrapper electionCopy;
+  pkt->RemoveHeader (electionCopy);
+  NS_TEST_ASSERT_MSG_EQ (electionCopy.IsElectionMessage (), true, "Should be an election message");
+  NS_TEST_ASSERT_MSG_EQ (electionCopy.GetSenderId (), 7, "Sender ID should match");
+  NS_TEST_ASSERT_MSG_EQ (electionCopy.GetClassId (), 3, "Class ID should match");
+  NS_TEST_ASSERT_MSG_EQ (electionCopy.GetPdsf (), 149, "PDSF should match");
+  NS_TEST_ASSERT_MSG_EQ_TOL (electionCopy.GetScore (), 0.5, 1e-4, "Score should match");
+  NS_TEST_ASSERT_MSG_EQ (electionCopy.GetHash (), 0xCAFEBABE, "Hash should match");
+
+  // Deserialize only consumes the header, and rejects truncated headers
+  BleDiscoveryHeaderWrapper formats[2];
+  formats[0] = original;
+  formats[1] = original;
+  formats[1].SetWireFormat (BLE_WIRE_FORMAT_LEGACY);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      uint32_t size = formats[i].GetSerializedSize ();
+      Buffer buffer;
+      buffer.AddAtStart (size + 50);
+      formats[i].Serialize (buffer.Begin ());
+      NS_TEST_ASSERT_MSG_EQ (copy.Deserialize (buffer.Begin ()), size,
+                             "Deserialize should read only the header");
+      NS_TEST_ASSERT_MSG_EQ (copy.GetSenderId (), 1010, "Sender ID should match");
+      buffer.RemoveAtEnd (50 + 1);
+      NS_TEST_ASSERT_MSG_EQ (copy.Deserialize (buffer.Begin ()), 0,
+                             "Truncated header should be rejected");
+    }
+
+  // Legacy headers are still accepted by the same receiver
+  BleDiscoveryHeaderWrapper legacy;
+  legacy.SetSenderId (55);
+  pkt = Create<Packet> ();
+  pkt->AddHeader (legacy);
+  pkt->RemoveHeader (copy);
+  NS_TEST_ASSERT_MSG_EQ (copy.GetWireFormat (), BLE_WIRE_FORMAT_LEGACY,
+                         "Legacy format should be detected");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetSenderId (), 55, "Legacy sender ID should match");
+}
+
 /**
  * \ingroup ble-mesh-discovery-test
  * \brief BLE Discovery Header Test Suite
@@ -434,6 +562,7 @@ BleDiscoveryHeaderTestSuite::BleDiscoveryHeaderTestSuite ()
   AddTestCase (new BleDiscoveryElectionTestCase, TestCase::QUICK);
   AddTestCase (new BleDiscoveryGpsTestCase, TestCase::QUICK);
   AddTestCase (new BleDiscoveryTypeIdTestCase, TestCase::QUICK);
+  AddTestCase (new BleDiscoveryWireFormatTestCase, TestCase::QUICK);
 }
 
 static BleDiscoveryHeaderTestSuite bleMeshDiscoveryHeaderTestSuite;
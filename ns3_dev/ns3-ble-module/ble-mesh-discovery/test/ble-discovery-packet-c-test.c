@@ -265,6 +265,7 @@ void test_election_serialization(void)
 
     original.election.class_id = 42;
     original.election.pdsf = 150;
+    original.election.pdsf_product = 120;
     original.election.score = 0.87;
     original.election.hash = 0xDEADBEEF;
 
@@ -293,6 +294,8 @@ void test_election_serialization(void)
     // Verify election fields
     TEST_ASSERT_EQ(deserialized.election.class_id, original.election.class_id, "Class ID should match");
     TEST_ASSERT_EQ(deserialized.election.pdsf, original.election.pdsf, "PDSF should match");
+    TEST_ASSERT_EQ(deserialized.election.pdsf_product, 0,
+                   "Legacy format should not carry the PDSF product");
     TEST_ASSERT_DOUBLE_EQ(deserialized.election.score, original.election.score, "Score should match");
     TEST_ASSERT_EQ(deserialized.election.hash, original.election.hash, "Hash should match");
 }
@@ -364,6 +367,111 @@ void test_pdsf_calculation(void)
     TEST_ASSERT_EQ(pdsf, 0, "Zero hops should return 0");
 }
 
+/**
+ * Reference PDSF: every prefix product from scratch, in 64 bits
+ */
+static uint64_t reference_pdsf(const uint32_t *direct_counts, uint16_t hop_count)
+{
+    uint64_t pdsf = 0;
+    for (uint16_t i = 0; i < hop_count; i++) {
+        uint64_t product = 1;
+        for (uint16_t j = 0; j <= i; j++) {
+            product *= direct_counts[j];
+        }
+        pdsf += product;
+    }
+    return pdsf;
+}
+
+/**
+ * Test: Incremental PDSF matches the reference and saturates
+ */
+void test_pdsf_incremental(void)
+{
+    // Small counts over a long path, within 32 bits
+    uint32_t counts[20];
+    uint32_t seed = 12345;
+    bool all_match = true;
+    for (uint16_t trial = 0; trial < 200; trial++) {
+        uint16_t hops = (uint16_t)(1 + trial % 20);
+        for (uint16_t i = 0; i < hops; i++) {
+            seed = seed * 1103515245u + 12345u;
+            counts[i] = (seed >> 16) % 4;
+        }
+        uint64_t expected = reference_pdsf(counts, hops);
+        if (expected > UINT32_MAX) continue;
+        all_match = all_match && ble_election_calculate_pdsf(counts, hops) == expected;
+    }
+    TEST_ASSERT(all_match, "Incremental PDSF should match the reference");
+
+    // Overflow saturates instead of wrapping
+    uint32_t large[] = {70000, 70000, 70000};
+    TEST_ASSERT_EQ(ble_election_calculate_pdsf(large, 3), UINT32_MAX,
+                   "Overflowing PDSF should saturate");
+    ble_pdsf_accumulator_t accumulator;
+    ble_pdsf_init(&accumulator);
+    for (int i = 0; i < 10; i++) {
+        ble_pdsf_append(&accumulator, UINT32_MAX);
+    }
+    TEST_ASSERT_EQ(accumulator.sum, UINT64_MAX, "64-bit sum should saturate");
+    TEST_ASSERT_EQ(accumulator.product, UINT64_MAX, "64-bit product should saturate");
+    ble_pdsf_append(&accumulator, 0);
+    TEST_ASSERT_EQ(accumulator.product, 0, "A zero count should end the product");
+    TEST_ASSERT_EQ(accumulator.sum, UINT64_MAX, "Sum should stay saturated");
+}
+
+/**
+ * Test: Forwarding nodes append to an announcement hop by hop
+ */
+void test_pdsf_append_to_announcement(void)
+{
+    uint32_t counts[] = {3, 4, 5, 2, 7, 1, 6};
+    uint16_t hops = sizeof(counts) / sizeof(counts[0]);
+
+    ble_election_packet_t announcement;
+    ble_election_packet_init(&announcement);
+    TEST_ASSERT_EQ(announcement.election.pdsf_product, 1, "Empty product should be 1");
+
+    // Each hop receives the serialized announcement and appends its count
+    bool all_match = true;
+    for (uint16_t i = 0; i < hops; i++) {
+        uint8_t buffer[512];
+        uint32_t size = ble_election_serialize_compact(&announcement, buffer, sizeof(buffer));
+        ble_election_packet_t received;
+        uint32_t read = ble_election_deserialize_compact(&received, buffer, size);
+        all_match = all_match && read == size;
+
+        ble_election_append_pdsf(&received.election, counts[i]);
+        all_match = all_match &&
+            received.election.pdsf == ble_election_calculate_pdsf(counts, (uint16_t)(i + 1));
+        announcement = received;
+    }
+    TEST_ASSERT(all_match, "Hop-by-hop PDSF should match the reference");
+    TEST_ASSERT_EQ(announcement.election.pdsf, 3 + 12 + 60 + 120 + 840 + 840 + 5040,
+                   "Final PDSF should match the expanded sum");
+
+    // The legacy layout is unchanged, so the product is not carried
+    uint8_t legacy[512];
+    uint32_t legacy_size = ble_election_serialize(&announcement, legacy, sizeof(legacy));
+    TEST_ASSERT_EQ(legacy_size, ble_discovery_get_size(&announcement.base) + 18,
+                   "Legacy election fields should stay 18 bytes");
+    ble_election_packet_t legacy_received;
+    ble_election_deserialize(&legacy_received, legacy, legacy_size);
+    ble_election_append_pdsf(&legacy_received.election, 4);
+    TEST_ASSERT_EQ(legacy_received.election.pdsf, announcement.election.pdsf,
+                   "Appending without the product should keep the PDSF");
+
+    // Saturated announcements stay saturated
+    ble_election_data_t election;
+    election.pdsf = 4000000000u;
+    election.pdsf_product = 3000000000u;
+    ble_election_append_pdsf(&election, 2);
+    TEST_ASSERT_EQ(election.pdsf, UINT32_MAX, "PDSF should saturate");
+    TEST_ASSERT_EQ(election.pdsf_product, UINT32_MAX, "Product should saturate");
+    ble_election_append_pdsf(&election, 3);
+    TEST_ASSERT_EQ(election.pdsf, UINT32_MAX, "Saturated PDSF should stay saturated");
+}
+
 /**
  * Test: Score calculation
  */
@@ -437,6 +545,301 @@ void test_large_path_serialization(void)
     }
 }
 
+/**
+ * Test: Compact format round trip of a discovery packet
+ */
+void test_compact_discovery_serialization(void)
+{
+    ble_discovery_packet_t original, legacy, compact;
+    ble_discovery_packet_init(&original);
+
+    original.sender_id = 12345;
+    original.ttl = 7;
+    ble_discovery_add_to_path(&original, 12345);
+    ble_discovery_add_to_path(&original, 12340);
+    ble_discovery_add_to_path(&original, 99);
+    ble_discovery_set_gps(&original, 10.5, -20.25, 30.0);
+
+    // Decode the same packet from both formats
+    uint8_t buffer[256];
+    uint32_t legacy_size = ble_discovery_serialize(&original, buffer, sizeof(buffer));
+    ble_discovery_packet_init(&legacy);
+    ble_discovery_deserialize(&legacy, buffer, legacy_size);
+
+    uint32_t size = ble_discovery_get_compact_size(&original);
+    uint32_t bytes_written = ble_discovery_serialize_compact(&original, buffer, sizeof(buffer));
+    TEST_ASSERT_EQ(bytes_written, size, "Bytes written should match calculated compact size");
+    TEST_ASSERT(bytes_written < legacy_size, "Compact format should be smaller than legacy");
+
+    ble_discovery_packet_init(&compact);
+    uint32_t bytes_read = ble_discovery_deserialize_compact(&compact, buffer, bytes_written);
+    TEST_ASSERT_EQ(bytes_read, bytes_written, "Bytes read should match bytes written");
+
+    TEST_ASSERT_EQ(compact.message_type, legacy.message_type, "Message type should match legacy");
+    TEST_ASSERT_EQ(compact.sender_id, legacy.sender_id, "Sender ID should match legacy");
+    TEST_ASSERT_EQ(compact.ttl, legacy.ttl, "TTL should match legacy");
+    TEST_ASSERT_EQ(compact.path_length, legacy.path_length, "Path length should match legacy");
+    for (uint16_t i = 0; i < legacy.path_length; i++)
+    {
+        TEST_ASSERT_EQ(compact.path[i], legacy.path[i], "Path node should match legacy");
+    }
+    TEST_ASSERT_EQ(compact.gps_available, legacy.gps_available, "GPS availability should match legacy");
+    TEST_ASSERT(fabs(compact.gps_location.x - legacy.gps_location.x) <= 0.5 / BLE_COMPACT_GPS_SCALE,
+                "GPS X should match legacy within the resolution");
+    TEST_ASSERT(fabs(compact.gps_location.y - legacy.gps_location.y) <= 0.5 / BLE_COMPACT_GPS_SCALE,
+                "GPS Y should match legacy within the resolution");
+    TEST_ASSERT(fabs(compact.gps_location.z - legacy.gps_location.z) <= 0.5 / BLE_COMPACT_GPS_SCALE,
+                "GPS Z should match legacy within the resolution");
+
+    // Without GPS only the header flag remains
+    original.gps_available = false;
+    bytes_written = ble_discovery_serialize_compact(&original, buffer, sizeof(buffer));
+    bytes_read = ble_discovery_deserialize_compact(&compact, buffer, bytes_written);
+    TEST_ASSERT_EQ(bytes_read, bytes_written, "Bytes read should match bytes written without GPS");
+    TEST_ASSERT_EQ(compact.gps_available, false, "GPS should not be available");
+}
+
+/**
+ * Test: Compact format round trip of an election packet
+ */
+void test_compact_election_serialization(void)
+{
+    ble_election_packet_t original, legacy, compact;
+    ble_election_packet_init(&original);
+
+    original.base.sender_id = 67890;
+    original.base.ttl = 8;
+    ble_discovery_add_to_path(&original.base, 5);
+    ble_discovery_add_to_path(&original.base, 6);
+    ble_discovery_set_gps(&original.base, 40.7, -74.0, 10.0);
+    original.election.class_id = 42;
+    original.election.pdsf = 150;
+    original.election.score = 0.87;
+    original.election.hash = 0xDEADBEEF;
+
+    uint8_t buffer[512];
+    uint32_t legacy_size = ble_election_serialize(&original, buffer, sizeof(buffer));
+    ble_election_packet_init(&legacy);
+    ble_election_deserialize(&legacy, buffer, legacy_size);
+
+    uint32_t size = ble_election_get_compact_size(&original);
+    uint32_t bytes_written = ble_election_serialize_compact(&original, buffer, sizeof(buffer));
+    TEST_ASSERT_EQ(bytes_written, size, "Bytes written should match calculated compact size");
+    TEST_ASSERT_EQ(ble_discovery_detect_format(buffer, bytes_written), BLE_WIRE_FORMAT_COMPACT,
+                   "Compact election packet should be detected");
+
+    ble_election_packet_init(&compact);
+    uint32_t bytes_read = ble_election_deserialize_compact(&compact, buffer, bytes_written);
+    TEST_ASSERT_EQ(bytes_read, bytes_written, "Bytes read should match bytes written");
+
+    TEST_ASSERT_EQ(compact.base.message_type, BLE_MSG_ELECTION_ANNOUNCEMENT,
+                   "Message type should be ELECTION_ANNOUNCEMENT");
+    TEST_ASSERT_EQ(compact.base.sender_id, legacy.base.sender_id, "Sender ID should match legacy");
+    TEST_ASSERT_EQ(compact.base.path_length, legacy.base.path_length, "Path length should match legacy");
+    TEST_ASSERT_EQ(compact.election.class_id, legacy.election.class_id, "Class ID should match legacy");
+    TEST_ASSERT_EQ(compact.election.pdsf, legacy.election.pdsf, "PDSF should match legacy");
+    TEST_ASSERT(fabs(compact.election.score - legacy.election.score) <= 0.5 / BLE_COMPACT_SCORE_SCALE,
+                "Score should match legacy within the resolution");
+    TEST_ASSERT_EQ(compact.election.hash, legacy.election.hash, "Hash should match legacy");
+
+    // A compact discovery packet is not an election packet
+    ble_discovery_packet_t discovery;
+    ble_discovery_packet_init(&discovery);
+    bytes_written = ble_discovery_serialize_compact(&discovery, buffer, sizeof(buffer));
+    bytes_read = ble_election_deserialize_compact(&compact, buffer, bytes_written);
+    TEST_ASSERT_EQ(bytes_read, 0, "Discovery packet should not deserialize as election");
+}
+
+/**
+ * Test: Compact format fits a 10-hop discovery in a legacy advertising payload
+ */
+void test_compact_advertising_size(void)
+{
+    ble_discovery_packet_t packet;
+    ble_discovery_packet_init(&packet);
+
+    packet.sender_id = 1010;
+    packet.ttl = 0;
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        ble_discovery_add_to_path(&packet, 1000 + i * 7);
+    }
+    ble_discovery_set_gps(&packet, 250.37, 480.12, 1.5);
+
+    TEST_ASSERT(ble_discovery_get_size(&packet) > 31, "Legacy 10-hop packet exceeds 31 bytes");
+    TEST_ASSERT(ble_discovery_get_compact_size(&packet) <= 31,
+                "Compact 10-hop packet should fit in 31 bytes");
+}
+
+/**
+ * Test: Compact format keeps extreme values exact or saturated
+ */
+void test_compact_extreme_values(void)
+{
+    ble_discovery_packet_t original, deserialized;
+    ble_discovery_packet_init(&original);
+
+    original.sender_id = 0xFFFFFFFF;
+    original.ttl = 255;
+    uint32_t ids[] = {0, 0xFFFFFFFF, 1, 0x80000000, 0x7FFFFFFF, 0x80000000, 0};
+    for (uint32_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++)
+    {
+        ble_discovery_add_to_path(&original, ids[i]);
+    }
+    ble_discovery_set_gps(&original, 1e12, -1e12, -0.004);
+
+    uint8_t buffer[512];
+    uint32_t bytes_written = ble_discovery_serialize_compact(&original, buffer, sizeof(buffer));
+    TEST_ASSERT_EQ(bytes_written, ble_discovery_get_compact_size(&original),
+                   "Bytes written should match calculated compact size");
+
+    ble_discovery_packet_init(&deserialized);
+    uint32_t bytes_read = ble_discovery_deserialize_compact(&deserialized, buffer, bytes_written);
+    TEST_ASSERT_EQ(bytes_read, bytes_written, "Bytes read should match bytes written");
+    TEST_ASSERT_EQ(deserialized.sender_id, 0xFFFFFFFF, "Largest sender ID should be preserved");
+    TEST_ASSERT_EQ(deserialized.ttl, 255, "Largest TTL should be preserved");
+    for (uint16_t i = 0; i < original.path_length; i++)
+    {
+        TEST_ASSERT_EQ(deserialized.path[i], original.path[i], "Path node should be exact");
+    }
+    TEST_ASSERT_DOUBLE_EQ(deserialized.gps_location.x, 2147483647 / BLE_COMPACT_GPS_SCALE,
+                          "Large GPS X should saturate");
+    TEST_ASSERT_DOUBLE_EQ(deserialized.gps_location.y, -2147483648.0 / BLE_COMPACT_GPS_SCALE,
+                          "Large negative GPS Y should saturate");
+    TEST_ASSERT_DOUBLE_EQ(deserialized.gps_location.z, 0.0, "Small GPS Z should round to 0");
+}
+
+/**
+ * Test: Compact format detection and malformed input
+ */
+void test_compact_malformed_input(void)
+{
+    ble_discovery_packet_t packet, deserialized;
+    ble_discovery_packet_init(&packet);
+    packet.sender_id = 300;
+    ble_discovery_add_to_path(&packet, 200);
+    ble_discovery_add_to_path(&packet, 100000);
+    ble_discovery_set_gps(&packet, 1.0, 2.0, 3.0);
+
+    uint8_t buffer[256];
+    uint32_t legacy_size = ble_discovery_serialize(&packet, buffer, sizeof(buffer));
+    TEST_ASSERT_EQ(ble_discovery_detect_format(buffer, legacy_size), BLE_WIRE_FORMAT_LEGACY,
+                   "Legacy packet should be detected");
+    TEST_ASSERT_EQ(ble_discovery_deserialize_compact(&deserialized, buffer, legacy_size), 0,
+                   "Legacy packet should not deserialize as compact");
+
+    uint32_t size = ble_discovery_serialize_compact(&packet, buffer, sizeof(buffer));
+    TEST_ASSERT_EQ(ble_discovery_detect_format(buffer, size), BLE_WIRE_FORMAT_COMPACT,
+                   "Compact packet should be detected");
+
+    // Every truncation is rejected
+    for (uint32_t length = 0; length < size; length++)
+    {
+        TEST_ASSERT_EQ(ble_discovery_deserialize_compact(&deserialized, buffer, length), 0,
+                       "Truncated compact packet should be rejected");
+    }
+
+    // Too small output buffer
+    TEST_ASSERT_EQ(ble_discovery_serialize_compact(&packet, buffer, size - 1), 0,
+                   "Should return 0 when buffer too small");
+
+    // Unknown version
+    buffer[0] = (uint8_t)((buffer[0] & ~0x30) | ((BLE_COMPACT_VERSION + 1) << 4));
+    TEST_ASSERT_EQ(ble_discovery_deserialize_compact(&deserialized, buffer, size), 0,
+                   "Unknown compact version should be rejected");
+
+    // Invalid path length
+    uint8_t invalid[] = {BLE_COMPACT_MARKER | (BLE_COMPACT_VERSION << 4), 10, 1,
+                         BLE_DISCOVERY_MAX_PATH_LENGTH + 1};
+    TEST_ASSERT_EQ(ble_discovery_deserialize_compact(&deserialized, invalid, sizeof(invalid)), 0,
+                   "Should return 0 for invalid path length");
+
+    // Varint longer than 32 bits
+    uint8_t overlong[] = {BLE_COMPACT_MARKER | (BLE_COMPACT_VERSION << 4), 10,
+                          0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0};
+    TEST_ASSERT_EQ(ble_discovery_deserialize_compact(&deserialized, overlong, sizeof(overlong)), 0,
+                   "Should return 0 for a sender ID longer than 32 bits");
+}
+
+/**
+ * Byte stream used by the stream tests: a fixed array and a position
+ */
+typedef struct {
+    uint8_t bytes[256];
+    uint32_t length;
+    uint32_t position;
+} test_stream_t;
+
+static void test_stream_write(void *context, uint8_t value)
+{
+    test_stream_t *stream = (test_stream_t *)context;
+    stream->bytes[stream->length++] = value;
+}
+
+static bool test_stream_read(void *context, uint8_t *value)
+{
+    test_stream_t *stream = (test_stream_t *)context;
+    if (stream->position >= stream->length) return false;
+    *value = stream->bytes[stream->position++];
+    return true;
+}
+
+/**
+ * Test: Stream serialization matches the buffer functions and reads only the packet
+ */
+void test_stream_serialization(void)
+{
+    ble_election_packet_t original, deserialized;
+    ble_election_packet_init(&original);
+    original.base.sender_id = 4242;
+    ble_discovery_add_to_path(&original.base, 4242);
+    ble_discovery_add_to_path(&original.base, 4243);
+    ble_discovery_set_gps(&original.base, 1.25, 2.5, 3.75);
+    original.election.class_id = 2;
+    original.election.pdsf = 99;
+    original.election.score = 0.25;
+    original.election.hash = 0x01020304;
+
+    ble_wire_format_t formats[] = {BLE_WIRE_FORMAT_LEGACY, BLE_WIRE_FORMAT_COMPACT};
+    for (int f = 0; f < 2; f++)
+    {
+        test_stream_t stream;
+        memset(&stream, 0, sizeof(stream));
+        ble_packet_writer_t writer = {test_stream_write, &stream};
+        ble_packet_reader_t reader = {test_stream_read, &stream};
+
+        // Same bytes as the buffer functions
+        uint8_t buffer[256];
+        uint32_t size = (formats[f] == BLE_WIRE_FORMAT_COMPACT) ?
+            ble_election_serialize_compact(&original, buffer, sizeof(buffer)) :
+            ble_election_serialize(&original, buffer, sizeof(buffer));
+        uint32_t bytes_written = ble_election_write(&original, formats[f], &writer);
+        TEST_ASSERT_EQ(bytes_written, size, "Stream should write as many bytes as the buffer function");
+        TEST_ASSERT_EQ(stream.length, size, "Writer should receive every byte");
+        TEST_ASSERT(memcmp(stream.bytes, buffer, size) == 0, "Stream bytes should match the buffer function");
+
+        // Trailing payload is not consumed
+        stream.length += 10;
+        ble_election_packet_init(&deserialized);
+        uint32_t bytes_read = ble_election_read(&deserialized, formats[f], &reader);
+        TEST_ASSERT_EQ(bytes_read, size, "Stream should read only the packet");
+        TEST_ASSERT_EQ(stream.position, size, "Reader should stop at the end of the packet");
+        TEST_ASSERT_EQ(deserialized.base.sender_id, 4242, "Sender ID should match");
+        TEST_ASSERT_EQ(deserialized.election.hash, 0x01020304, "Hash should match");
+
+        // Truncated packets are rejected
+        stream.length = size - 1;
+        stream.position = 0;
+        TEST_ASSERT_EQ(ble_election_read(&deserialized, formats[f], &reader), 0,
+                       "Truncated stream should be rejected");
+    }
+
+    // Missing callbacks are rejected
+    ble_packet_writer_t no_writer = {NULL, NULL};
+    TEST_ASSERT_EQ(ble_discovery_write(&original.base, BLE_WIRE_FORMAT_LEGACY, &no_writer), 0,
+                   "Writer without callback should be rejected");
+}
+
 /**
  * Main test runner
  */
@@ -456,9 +859,17 @@ int main(void)
     test_buffer_overflow_protection();
     test_invalid_path_length();
     test_pdsf_calculation();
+    test_pdsf_incremental();
+    test_pdsf_append_to_announcement();
     test_score_calculation();
     test_hash_generation();
     test_large_path_serialization();
+    test_compact_discovery_serialization();
+    test_compact_election_serialization();
+    test_compact_advertising_size();
+    test_compact_extreme_values();
+    test_compact_malformed_input();
+    test_stream_serialization();
 
     printf("\n=== Test Results ===\n");
     printf("Passed: %d\n", tests_passed);
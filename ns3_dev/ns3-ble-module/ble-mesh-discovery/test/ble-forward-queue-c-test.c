@@ -0,0 +1,257 @@
+/**
+ * @file ble-forward-queue-c-test.c
+ * @brief Standalone C tests for the TTL-priority forwarding queue
+ *
+ * Pure C test suite for the bucketed forwarding queue
+ * Tests ordering, top-3 selection, overflow eviction, and node integration
+ */
+
+#include "../model/protocol-core/ble_mesh_node.h"
+#include <stdio.h>
+#include <string.h>
+
+#if BLE_FORWARD_QUEUE_CAPACITY < 6
+#error "The ordering tests queue up to 6 messages at once"
+#endif
+
+/* Test counter */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (condition) { \
+            tests_passed++; \
+        } else { \
+            tests_failed++; \
+            printf("FAIL: %s (line %d): %s\n", __func__, __LINE__, message); \
+        } \
+    } while(0)
+
+static ble_discovery_packet_t make_packet(uint32_t sender_id, uint8_t ttl)
+{
+    ble_discovery_packet_t packet;
+    ble_discovery_packet_init(&packet);
+    packet.sender_id = sender_id;
+    packet.ttl = ttl;
+    return packet;
+}
+
+/* ===== Test: Ordering ===== */
+
+void test_queue_empty(void)
+{
+    printf("Running test_queue_empty...\n");
+
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    ble_discovery_packet_t packet;
+    TEST_ASSERT(ble_forward_queue_count(&queue) == 0, "New queue should be empty");
+    TEST_ASSERT(ble_forward_queue_peek(&queue) == NULL, "Peek on empty queue should be NULL");
+    TEST_ASSERT(!ble_forward_queue_pop(&queue, &packet), "Pop on empty queue should fail");
+}
+
+void test_queue_ttl_order(void)
+{
+    printf("Running test_queue_ttl_order...\n");
+
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    uint8_t ttls[] = {3, 9, 1, 7, 9, 5};
+    for (uint32_t i = 0; i < sizeof(ttls); i++) {
+        ble_discovery_packet_t packet = make_packet(100 + i, ttls[i]);
+        TEST_ASSERT(ble_forward_queue_push(&queue, &packet), "Push should succeed");
+    }
+    TEST_ASSERT(ble_forward_queue_count(&queue) == 6, "Queue should hold 6 messages");
+    TEST_ASSERT(ble_forward_queue_peek(&queue)->sender_id == 101,
+                "Peek should return the oldest message of the highest TTL");
+
+    // Highest TTL first, arrival order among equal TTLs
+    uint32_t expected_senders[] = {101, 104, 103, 105, 100, 102};
+    bool in_order = true;
+    ble_discovery_packet_t packet;
+    for (uint32_t i = 0; i < 6; i++) {
+        in_order = in_order && ble_forward_queue_pop(&queue, &packet) &&
+                   packet.sender_id == expected_senders[i];
+    }
+    TEST_ASSERT(in_order, "Messages should leave by TTL, then arrival");
+    TEST_ASSERT(ble_forward_queue_count(&queue) == 0, "Queue should be empty");
+}
+
+void test_queue_high_ttl_clamped(void)
+{
+    printf("Running test_queue_high_ttl_clamped...\n");
+
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    ble_discovery_packet_t first = make_packet(1, BLE_DISCOVERY_DEFAULT_TTL);
+    ble_discovery_packet_t second = make_packet(2, 200);
+    ble_forward_queue_push(&queue, &first);
+    ble_forward_queue_push(&queue, &second);
+
+    ble_discovery_packet_t packet;
+    ble_forward_queue_pop(&queue, &packet);
+    TEST_ASSERT(packet.sender_id == 1, "TTLs above the default share the top bucket");
+    ble_forward_queue_pop(&queue, &packet);
+    TEST_ASSERT(packet.ttl == 200, "TTL should be preserved in the copy");
+}
+
+void test_queue_rejects_zero_ttl(void)
+{
+    printf("Running test_queue_rejects_zero_ttl...\n");
+
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    ble_discovery_packet_t packet = make_packet(1, 0);
+    TEST_ASSERT(!ble_forward_queue_push(&queue, &packet), "TTL 0 should be refused");
+    TEST_ASSERT(queue.rejected == 1, "Refusal should be counted");
+    TEST_ASSERT(ble_forward_queue_count(&queue) == 0, "Queue should stay empty");
+}
+
+/* ===== Test: Top-k Selection ===== */
+
+void test_queue_pop_top(void)
+{
+    printf("Running test_queue_pop_top...\n");
+
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    for (uint8_t ttl = 1; ttl <= 5; ttl++) {
+        ble_discovery_packet_t packet = make_packet(ttl, ttl);
+        ble_forward_queue_push(&queue, &packet);
+    }
+
+    ble_discovery_packet_t top[BLE_FORWARD_SLOTS_PER_CYCLE];
+    uint16_t taken = ble_forward_queue_pop_top(&queue, top, BLE_FORWARD_SLOTS_PER_CYCLE);
+    TEST_ASSERT(taken == 3, "Should take three messages");
+    TEST_ASSERT(top[0].ttl == 5 && top[1].ttl == 4 && top[2].ttl == 3,
+                "Should take the three highest TTLs in order");
+    TEST_ASSERT(ble_forward_queue_count(&queue) == 2, "Two messages should remain");
+
+    taken = ble_forward_queue_pop_top(&queue, top, BLE_FORWARD_SLOTS_PER_CYCLE);
+    TEST_ASSERT(taken == 2, "Should take only what remains");
+}
+
+/* ===== Test: Overflow ===== */
+
+void test_queue_overflow_eviction(void)
+{
+    printf("Running test_queue_overflow_eviction...\n");
+
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    // Fill with TTL 2, the first message of which is the oldest
+    for (uint32_t i = 0; i < BLE_FORWARD_QUEUE_CAPACITY; i++) {
+        ble_discovery_packet_t packet = make_packet(i, 2);
+        ble_forward_queue_push(&queue, &packet);
+    }
+    TEST_ASSERT(ble_forward_queue_count(&queue) == BLE_FORWARD_QUEUE_CAPACITY, "Queue full");
+
+    // Equal or lower TTL is refused
+    ble_discovery_packet_t low = make_packet(900, 2);
+    TEST_ASSERT(!ble_forward_queue_push(&queue, &low), "Equal TTL should be refused when full");
+    TEST_ASSERT(queue.rejected == 1, "Refusal should be counted");
+
+    // Higher TTL displaces the oldest lowest-TTL message
+    ble_discovery_packet_t high = make_packet(901, 8);
+    TEST_ASSERT(ble_forward_queue_push(&queue, &high), "Higher TTL should be queued");
+    TEST_ASSERT(queue.evicted == 1, "Eviction should be counted");
+    TEST_ASSERT(ble_forward_queue_count(&queue) == BLE_FORWARD_QUEUE_CAPACITY,
+                "Queue should stay full");
+
+    ble_discovery_packet_t packet;
+    ble_forward_queue_pop(&queue, &packet);
+    TEST_ASSERT(packet.sender_id == 901, "Higher TTL should leave first");
+    ble_forward_queue_pop(&queue, &packet);
+    TEST_ASSERT(packet.sender_id == 1, "Oldest TTL 2 message should have been evicted");
+}
+
+void test_queue_clear_reuses_entries(void)
+{
+    printf("Running test_queue_clear_reuses_entries...\n");
+
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    // Several fill/drain rounds must not leak entries
+    bool all_queued = true;
+    for (uint32_t round = 0; round < 4; round++) {
+        for (uint32_t i = 0; i < BLE_FORWARD_QUEUE_CAPACITY; i++) {
+            ble_discovery_packet_t packet = make_packet(i, (uint8_t)(1 + i % 10));
+            all_queued = all_queued && ble_forward_queue_push(&queue, &packet);
+        }
+        if (round % 2 == 0) {
+            ble_forward_queue_clear(&queue);
+        } else {
+            while (ble_forward_queue_pop(&queue, NULL)) {
+            }
+        }
+    }
+    TEST_ASSERT(all_queued, "Every round should fit the whole capacity");
+    TEST_ASSERT(queue.evicted == 0 && queue.rejected == 0, "Nothing should be displaced");
+}
+
+/* ===== Test: Node Integration ===== */
+
+void test_node_forwarding(void)
+{
+    printf("Running test_node_forwarding...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 1);
+    ble_forward_queue_t queue;
+    ble_forward_queue_init(&queue);
+
+    ble_discovery_packet_t packet = make_packet(2, 0);
+    TEST_ASSERT(!ble_mesh_node_queue_forward(&node, &queue, &packet), "TTL 0 should not be queued");
+    TEST_ASSERT(node.stats.messages_dropped == 1, "Refused message should count as dropped");
+
+    for (uint32_t i = 0; i < BLE_FORWARD_QUEUE_CAPACITY + 1; i++) {
+        packet = make_packet(10 + i, (uint8_t)(1 + i % BLE_DISCOVERY_DEFAULT_TTL));
+        ble_mesh_node_queue_forward(&node, &queue, &packet);
+    }
+    TEST_ASSERT(node.stats.messages_dropped == 2, "Evicted message should count as dropped");
+
+    ble_discovery_packet_t selected[BLE_FORWARD_SLOTS_PER_CYCLE];
+    uint16_t count = ble_mesh_node_select_forwards(&queue, selected);
+    TEST_ASSERT(count == BLE_FORWARD_SLOTS_PER_CYCLE, "Should select three messages");
+    uint8_t highest = BLE_FORWARD_QUEUE_CAPACITY < BLE_DISCOVERY_DEFAULT_TTL
+                      ? BLE_FORWARD_QUEUE_CAPACITY + 1 : BLE_DISCOVERY_DEFAULT_TTL;
+    TEST_ASSERT(selected[0].ttl == highest, "Highest TTL selected first");
+    TEST_ASSERT(selected[0].ttl >= selected[1].ttl && selected[1].ttl >= selected[2].ttl,
+                "Selection should be ordered by TTL");
+}
+
+/* ===== Main Test Runner ===== */
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("BLE Forward Queue C Test Suite\n");
+    printf("========================================\n\n");
+
+    /* Run all tests */
+    test_queue_empty();
+    test_queue_ttl_order();
+    test_queue_high_ttl_clamped();
+    test_queue_rejects_zero_ttl();
+    test_queue_pop_top();
+    test_queue_overflow_eviction();
+    test_queue_clear_reuses_entries();
+    test_node_forwarding();
+
+    /* Print results */
+    printf("\n========================================\n");
+    printf("Test Results:\n");
+    printf("  PASSED: %d\n", tests_passed);
+    printf("  FAILED: %d\n", tests_failed);
+    printf("========================================\n");
+
+    return (tests_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file ble-gps-proximity-c-test.c
+ * @brief Standalone C tests for the batched GPS proximity kernel
+ *
+ * Pure C test suite for ble_gps_proximity_mask()
+ * Tests agreement with a sqrt-based loop, boundaries, NaN handling, and
+ * parameter validation. Build once more with -DBLE_GPS_PROXIMITY_SCALAR to
+ * cover the scalar fallback.
+ */
+
+#include "../model/protocol-core/ble_gps_proximity.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/* Test counter */
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (condition) { \
+            tests_passed++; \
+        } else { \
+            tests_failed++; \
+            printf("FAIL: %s (line %d): %s\n", __func__, __LINE__, message); \
+        } \
+    } while(0)
+
+#define TEST_POINTS 300     /**< Covers several mask words and a partial one */
+
+/**
+ * @brief Small xorshift generator, so coordinates do not depend on the C library
+ */
+static uint32_t test_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/* ===== Test: Agreement ===== */
+
+void test_proximity_matches_distance(void)
+{
+    printf("Running test_proximity_matches_distance...\n");
+
+    static double x[TEST_POINTS], y[TEST_POINTS], z[TEST_POINTS];
+    uint64_t mask[BLE_GPS_MASK_WORDS(TEST_POINTS)];
+    ble_gps_location_t center = {50.0, -20.0, 5.0};
+    uint32_t rng = 0xC0FFEEu;
+
+    for (uint32_t i = 0; i < TEST_POINTS; i++) {
+        x[i] = (double)(test_random(&rng) % 20000) / 100.0 - 50.0;
+        y[i] = (double)(test_random(&rng) % 20000) / 100.0 - 120.0;
+        z[i] = (double)(test_random(&rng) % 2000) / 100.0;
+    }
+
+    // Every count, so each tail length of the two-point and 64-point steps is hit
+    bool all_match = true;
+    for (uint32_t count = 0; count <= TEST_POINTS; count++) {
+        uint32_t within = ble_gps_proximity_mask(x, y, z, count, &center, 80.0, mask);
+        uint32_t expected = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            double distance = sqrt((x[i] - center.x) * (x[i] - center.x) +
+                                   (y[i] - center.y) * (y[i] - center.y) +
+                                   (z[i] - center.z) * (z[i] - center.z));
+            bool inside = distance <= 80.0;
+            expected += inside;
+            all_match = all_match && ble_gps_mask_test(mask, i) == inside;
+        }
+        all_match = all_match && within == expected;
+        if (count % 64 != 0) {
+            // Bits past the last point stay clear
+            all_match = all_match && (mask[count / 64] >> (count % 64)) == 0;
+        }
+    }
+    TEST_ASSERT(all_match, "Mask and count should match a sqrt-based loop for every count");
+}
+
+/* ===== Test: Boundaries ===== */
+
+void test_proximity_boundary(void)
+{
+    printf("Running test_proximity_boundary...\n");
+
+    double x[5] = {3.0, 3.0, 0.0, 0.0, 0.0};
+    double y[5] = {4.0, 4.001, 0.0, 0.0, -5.0};
+    double z[5] = {0.0, 0.0, 0.0, 5.0, 0.0};
+    ble_gps_location_t center = {0.0, 0.0, 0.0};
+    uint64_t mask[1];
+
+    uint32_t within = ble_gps_proximity_mask(x, y, z, 5, &center, 5.0, mask);
+    TEST_ASSERT(within == 4, "Four points should be within 5 m");
+    TEST_ASSERT(ble_gps_mask_test(mask, 0), "Point exactly at the range should be included");
+    TEST_ASSERT(!ble_gps_mask_test(mask, 1), "Point just past the range should be excluded");
+    TEST_ASSERT(ble_gps_mask_test(mask, 2), "Point at the center should be included");
+    TEST_ASSERT(ble_gps_mask_test(mask, 3), "Height should count toward the distance");
+    TEST_ASSERT(ble_gps_mask_test(mask, 4), "Negative offsets should be handled");
+
+    within = ble_gps_proximity_mask(x, y, z, 5, &center, 0.0, mask);
+    TEST_ASSERT(within == 1 && mask[0] == 0x04, "Zero range should only include the center");
+}
+
+void test_proximity_nan_excluded(void)
+{
+    printf("Running test_proximity_nan_excluded...\n");
+
+    double x[4] = {0.0, NAN, 1.0, 0.0};
+    double y[4] = {0.0, 0.0, NAN, 0.0};
+    double z[4] = {0.0, 0.0, 0.0, NAN};
+    ble_gps_location_t center = {0.0, 0.0, 0.0};
+    uint64_t mask[1];
+
+    uint32_t within = ble_gps_proximity_mask(x, y, z, 4, &center, 1e9, mask);
+    TEST_ASSERT(within == 1, "Only the point without NaN should be within range");
+    TEST_ASSERT(mask[0] == 0x01, "NaN coordinates should never be marked");
+}
+
+/* ===== Test: Parameter Validation ===== */
+
+void test_proximity_invalid_parameters(void)
+{
+    printf("Running test_proximity_invalid_parameters...\n");
+
+    double x[2] = {0.0, 1.0};
+    double y[2] = {0.0, 1.0};
+    double z[2] = {0.0, 1.0};
+    ble_gps_location_t center = {0.0, 0.0, 0.0};
+    uint64_t mask[1] = {~0ull};
+
+    TEST_ASSERT(ble_gps_proximity_mask(x, y, z, 2, &center, -1.0, mask) == 0,
+                "Negative range should match nothing");
+    TEST_ASSERT(mask[0] == 0, "Mask should be cleared for a negative range");
+
+    mask[0] = ~0ull;
+    TEST_ASSERT(ble_gps_proximity_mask(x, y, z, 2, &center, NAN, mask) == 0,
+                "NaN range should match nothing");
+    TEST_ASSERT(mask[0] == 0, "Mask should be cleared for a NaN range");
+
+    mask[0] = ~0ull;
+    TEST_ASSERT(ble_gps_proximity_mask(x, y, z, 2, NULL, 10.0, mask) == 0,
+                "NULL center should match nothing");
+    TEST_ASSERT(mask[0] == 0, "Mask should be cleared for a NULL center");
+
+    TEST_ASSERT(ble_gps_proximity_mask(NULL, y, z, 2, &center, 10.0, mask) == 0,
+                "NULL coordinates should match nothing");
+    TEST_ASSERT(ble_gps_proximity_mask(x, y, z, 2, &center, 10.0, NULL) == 0,
+                "NULL mask should return 0");
+}
+
+/* ===== Main Test Runner ===== */
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("BLE GPS Proximity C Test Suite\n");
+    printf("========================================\n\n");
+
+    /* Run all tests */
+    test_proximity_matches_distance();
+    test_proximity_boundary();
+    test_proximity_nan_excluded();
+    test_proximity_invalid_parameters();
+
+    /* Print results */
+    printf("\n========================================\n");
+    printf("Test Results:\n");
+    printf("  PASSED: %d\n", tests_passed);
+    printf("  FAILED: %d\n", tests_failed);
+    printf("========================================\n");
+
+    return (tests_failed == 0) ? 0 : 1;
+}
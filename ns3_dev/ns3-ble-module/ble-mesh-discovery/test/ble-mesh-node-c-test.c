@@ -10,6 +10,7 @@
 
 #include "../model/protocol-core/ble_mesh_node.h"
 #include <stdio.h>
+#include <math.h>
 #include <string.h>
 #include <assert.h>
 
@@ -484,6 +485,330 @@ void test_max_neighbors_limit(void)
                 "Neighbor count should remain at maximum");
 }
 
+void test_neighbor_index_consistency(void)
+{
+    printf("Running test_neighbor_index_consistency...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 70);
+
+    // Fill the table; IDs with a large stride exercise probe collisions
+    for (uint32_t i = 0; i < BLE_MESH_MAX_NEIGHBORS; i++) {
+        ble_mesh_node_advance_cycle(&node);
+        ble_mesh_node_add_neighbor(&node, 1 + i * 65536, -60, 1);
+    }
+
+    bool all_found = true;
+    for (uint32_t i = 0; i < BLE_MESH_MAX_NEIGHBORS; i++) {
+        ble_neighbor_info_t *neighbor = ble_mesh_node_find_neighbor(&node, 1 + i * 65536);
+        all_found = all_found && neighbor && neighbor->node_id == 1 + i * 65536;
+    }
+    TEST_ASSERT(all_found, "Every neighbor should be found in a full table");
+    TEST_ASSERT(ble_mesh_node_find_neighbor(&node, 2) == NULL, "Unknown ID should not be found");
+
+    // Prune the older half; compaction moves the survivors
+    uint16_t removed = ble_mesh_node_prune_stale_neighbors(&node, BLE_MESH_MAX_NEIGHBORS / 2 - 1);
+    TEST_ASSERT(removed == BLE_MESH_MAX_NEIGHBORS / 2, "Half of the neighbors should be pruned");
+
+    bool index_consistent = true;
+    for (uint32_t i = 0; i < BLE_MESH_MAX_NEIGHBORS; i++) {
+        ble_neighbor_info_t *neighbor = ble_mesh_node_find_neighbor(&node, 1 + i * 65536);
+        bool kept = i >= BLE_MESH_MAX_NEIGHBORS / 2;
+        index_consistent = index_consistent && (kept ? neighbor && neighbor->node_id == 1 + i * 65536
+                                                     : neighbor == NULL);
+    }
+    TEST_ASSERT(index_consistent, "Index should follow compaction");
+
+    // Re-adding a pruned neighbor reuses the free space
+    TEST_ASSERT(ble_mesh_node_add_neighbor(&node, 1, -40, 1), "Re-add should succeed");
+    ble_neighbor_info_t *readded = ble_mesh_node_find_neighbor(&node, 1);
+    TEST_ASSERT(readded && readded->rssi == -40, "Re-added neighbor should be found");
+    TEST_ASSERT(node.neighbors.count == BLE_MESH_MAX_NEIGHBORS / 2 + 1,
+                "Count should include the re-added neighbor");
+}
+
+void test_neighbor_aggregates(void)
+{
+    printf("Running test_neighbor_aggregates...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 75);
+    ble_gps_location_t gps = {1.0, 2.0, 3.0};
+
+    // Mix of additions, updates that change hop count and RSSI, and GPS updates
+    for (uint32_t step = 0; step < 400; step++) {
+        uint32_t id = 1 + (step * 37) % 60;
+        int8_t rssi = (int8_t)(-40 - (int)((step * 13) % 50));
+        uint8_t hop_count = (uint8_t)(1 + (step % 3 == 0));
+        ble_mesh_node_add_neighbor(&node, id, rssi, hop_count);
+        if (step % 5 == 0) {
+            ble_mesh_node_update_neighbor_gps(&node, id, &gps);
+        }
+        if (step % 50 == 49) {
+            // Drop the neighbors not heard from in the last 50 steps
+            ble_mesh_node_advance_cycle(&node);
+            ble_mesh_node_prune_stale_neighbors(&node, 1);
+        }
+    }
+
+    uint16_t direct = 0;
+    uint16_t with_gps = 0;
+    int32_t rssi_sum = 0;
+    ble_neighbor_info_t neighbor;
+    for (uint16_t i = 0; ble_mesh_node_get_neighbor(&node, i, &neighbor); i++) {
+        direct += neighbor.hop_count == 1;
+        with_gps += neighbor.gps_valid;
+        rssi_sum += neighbor.rssi;
+    }
+    TEST_ASSERT(node.neighbors.count > 0 && node.neighbors.count < 60,
+                "Pruning should have removed some neighbors");
+    if (node.neighbors.count == 0) return;
+    TEST_ASSERT(ble_mesh_node_count_direct_neighbors(&node) == direct,
+                "Direct count should match a full scan");
+    TEST_ASSERT(ble_mesh_node_count_gps_neighbors(&node) == with_gps,
+                "GPS count should match a full scan");
+    TEST_ASSERT(ble_mesh_node_calculate_avg_rssi(&node) == (int8_t)(rssi_sum / node.neighbors.count),
+                "Average RSSI should match a full scan");
+
+    // Pruning everything resets the aggregates
+    ble_mesh_node_advance_cycle(&node);
+    ble_mesh_node_advance_cycle(&node);
+    ble_mesh_node_prune_stale_neighbors(&node, 0);
+    TEST_ASSERT(node.neighbors.count == 0, "All neighbors should be pruned");
+    TEST_ASSERT(node.neighbors.direct_count == 0 && node.neighbors.gps_valid_count == 0 &&
+                node.neighbors.rssi_sum == 0, "Aggregates should return to zero");
+}
+
+void test_neighbors_in_range(void)
+{
+    printf("Running test_neighbors_in_range...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 80);
+    ble_gps_location_t center = {100.0, 100.0, 0.0};
+    uint64_t mask[BLE_GPS_MASK_WORDS(BLE_MESH_MAX_NEIGHBORS)];
+
+    // Neighbor i sits i meters east of the center; every third has no GPS
+    for (uint32_t i = 0; i < 90; i++) {
+        ble_mesh_node_add_neighbor(&node, 1000 + i, -60, 1);
+        if (i % 3 != 0) {
+            ble_gps_location_t gps = {100.0 + i, 100.0, 0.0};
+            ble_mesh_node_update_neighbor_gps(&node, 1000 + i, &gps);
+        }
+    }
+
+    uint16_t within = ble_mesh_node_neighbors_in_range(&node, &center, 70.0, mask);
+    uint16_t expected = 0;
+    bool all_match = true;
+    ble_neighbor_info_t neighbor;
+    for (uint16_t i = 0; ble_mesh_node_get_neighbor(&node, i, &neighbor); i++) {
+        bool inside = neighbor.gps_valid && neighbor.gps.x - center.x <= 70.0;
+        expected += inside;
+        all_match = all_match && ble_gps_mask_test(mask, i) == inside;
+    }
+    // Only the first BLE_MESH_MAX_NEIGHBORS fit in the table
+    uint16_t stored = 90 < BLE_MESH_MAX_NEIGHBORS ? 90 : BLE_MESH_MAX_NEIGHBORS;
+    uint16_t placed = 0;
+    for (uint16_t i = 0; i < stored; i++) {
+        placed += (i % 3 != 0 && i <= 70);
+    }
+    TEST_ASSERT(within == placed && within == expected,
+                "Only neighbors with GPS within 70 m should be counted");
+    TEST_ASSERT(all_match, "Mask bits should follow table positions");
+
+    TEST_ASSERT(ble_mesh_node_neighbors_in_range(&node, NULL, 70.0, mask) == 0,
+                "NULL center should match nothing");
+    TEST_ASSERT(mask[0] == 0, "Mask should be cleared for a NULL center");
+}
+
+void test_batch_neighbor_ingestion(void)
+{
+    printf("Running test_batch_neighbor_ingestion...\n");
+
+    ble_mesh_node_t batched;
+    ble_mesh_node_t sequential;
+    ble_mesh_node_init(&batched, 77);
+    ble_mesh_node_init(&sequential, 77);
+
+    // One noisy slot: repeated senders, changing hop counts, some with GPS
+    ble_neighbor_observation_t observations[40];
+    for (uint16_t i = 0; i < 40; i++) {
+        ble_neighbor_observation_t *observation = &observations[i];
+        observation->node_id = 500 + (i * 7) % 13;
+        observation->rssi = (int8_t)(-45 - i);
+        observation->hop_count = (uint8_t)(1 + i % 2);
+        observation->gps_valid = (i % 3 == 0);
+        observation->gps.x = i;
+        observation->gps.y = 2.0 * i;
+        observation->gps.z = 0.0;
+
+        ble_mesh_node_add_neighbor(&sequential, observation->node_id,
+                                   observation->rssi, observation->hop_count);
+        if (observation->gps_valid) {
+            ble_mesh_node_update_neighbor_gps(&sequential, observation->node_id,
+                                              &observation->gps);
+        }
+    }
+
+    uint16_t stored = ble_mesh_node_add_neighbors(&batched, observations, 40);
+    TEST_ASSERT(stored == 40, "Every observation should be stored");
+    TEST_ASSERT(batched.neighbors.count == 13, "Repeated senders should be merged");
+
+    bool same = batched.neighbors.count == sequential.neighbors.count;
+    for (uint16_t i = 0; same && i < batched.neighbors.count; i++) {
+        ble_neighbor_info_t a;
+        ble_neighbor_info_t b;
+        ble_mesh_node_get_neighbor(&batched, i, &a);
+        ble_mesh_node_get_neighbor(&sequential, i, &b);
+        same = a.node_id == b.node_id && a.rssi == b.rssi && a.hop_count == b.hop_count &&
+               a.gps_valid == b.gps_valid && a.gps.x == b.gps.x && a.gps.y == b.gps.y;
+    }
+    TEST_ASSERT(same, "Batch should match one-by-one ingestion");
+    TEST_ASSERT(ble_mesh_node_count_direct_neighbors(&batched) ==
+                ble_mesh_node_count_direct_neighbors(&sequential), "Direct counts should match");
+    TEST_ASSERT(ble_mesh_node_count_gps_neighbors(&batched) ==
+                ble_mesh_node_count_gps_neighbors(&sequential), "GPS counts should match");
+    TEST_ASSERT(ble_mesh_node_calculate_avg_rssi(&batched) ==
+                ble_mesh_node_calculate_avg_rssi(&sequential), "Average RSSI should match");
+}
+
+void test_batch_neighbor_capacity(void)
+{
+    printf("Running test_batch_neighbor_capacity...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 78);
+    for (uint32_t i = 0; i < BLE_MESH_MAX_NEIGHBORS; i++) {
+        ble_mesh_node_add_neighbor(&node, 1000 + i, -60, 1);
+    }
+
+    // A full table still accepts updates, but not new neighbors
+    ble_neighbor_observation_t observations[2];
+    memset(observations, 0, sizeof(observations));
+    observations[0].node_id = 1000;
+    observations[0].rssi = -30;
+    observations[0].hop_count = 1;
+    observations[1].node_id = 9999;
+    observations[1].rssi = -30;
+    observations[1].hop_count = 1;
+
+    TEST_ASSERT(ble_mesh_node_add_neighbors(&node, observations, 2) == 1,
+                "Only the update should be stored");
+    TEST_ASSERT(ble_mesh_node_find_neighbor(&node, 1000)->rssi == -30, "Update applied");
+    TEST_ASSERT(ble_mesh_node_find_neighbor(&node, 9999) == NULL, "New neighbor refused");
+    TEST_ASSERT(ble_mesh_node_add_neighbors(&node, NULL, 2) == 0, "NULL batch stores nothing");
+}
+
+void test_append_pdsf(void)
+{
+    printf("Running test_append_pdsf...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 79);
+    ble_mesh_node_add_neighbor(&node, 1, -50, 1);
+    ble_mesh_node_add_neighbor(&node, 2, -50, 1);
+    ble_mesh_node_add_neighbor(&node, 3, -50, 2);
+
+    ble_election_packet_t announcement;
+    ble_election_packet_init(&announcement);
+    ble_election_append_pdsf(&announcement.election, 5);
+
+    ble_mesh_node_append_pdsf(&node, &announcement.election);
+    TEST_ASSERT(announcement.election.pdsf == 5 + 5 * 2, "Node should append its direct count");
+    TEST_ASSERT(announcement.election.pdsf_product == 10, "Product should include the node");
+}
+
+/*
+ * sizeof(ble_mesh_node_t) on x86-64 before the compact layout, with 150
+ * padded 48-byte neighbors. The forward queue is kept by the caller and
+ * is not part of it.
+ */
+#define BASELINE_NODE_BYTES 7320
+
+void test_neighbor_memory_report(void)
+{
+    printf("Running test_neighbor_memory_report...\n");
+
+#ifdef BLE_MESH_COMPACT_NEIGHBORS
+    const char *layout = "compact (columns)";
+    size_t per_neighbor = sizeof(uint32_t) * 2 + sizeof(int32_t) * 3 + sizeof(uint16_t) + 3;
+#else
+    const char *layout = "array of structs";
+    size_t per_neighbor = sizeof(ble_neighbor_info_t);
+#endif
+    printf("  layout:             %s\n", layout);
+    printf("  capacity:           %u neighbors, %u index slots\n",
+           BLE_MESH_MAX_NEIGHBORS, BLE_MESH_NEIGHBOR_INDEX_SIZE);
+    printf("  bytes per neighbor: %zu\n", per_neighbor);
+    printf("  neighbor table:     %zu bytes\n", sizeof(ble_neighbor_table_t));
+    printf("  dedup cache:        %zu bytes\n", sizeof(ble_dedup_cache_t));
+    printf("  node total:         %zu bytes (baseline %u)\n", sizeof(ble_mesh_node_t),
+           BASELINE_NODE_BYTES);
+    printf("  forward queue:      %zu bytes, kept by the caller\n", sizeof(ble_forward_queue_t));
+
+    // The columns and index dominate; everything else is a few dozen bytes
+    size_t bound = per_neighbor * BLE_MESH_MAX_NEIGHBORS + BLE_MESH_NEIGHBOR_INDEX_SIZE +
+                   sizeof(ble_neighbor_info_t) + 32;
+    TEST_ASSERT(sizeof(ble_neighbor_table_t) <= bound, "Table should hold no hidden padding");
+    TEST_ASSERT(sizeof(ble_neighbor_info_t) <= 40, "Neighbor info should not be padded");
+#if defined(BLE_MESH_COMPACT_NEIGHBORS) && BLE_MESH_MAX_NEIGHBORS <= 150
+    TEST_ASSERT(sizeof(ble_mesh_node_t) < BASELINE_NODE_BYTES,
+                "Compact node should be smaller than the baseline node");
+#endif
+
+    // GPS survives the layout within its resolution
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 76);
+    ble_gps_location_t gps = {123.456, -78.9, 0.004};
+    ble_mesh_node_add_neighbor(&node, 9, -60, 1);
+    ble_mesh_node_update_neighbor_gps(&node, 9, &gps);
+    ble_neighbor_info_t neighbor;
+    TEST_ASSERT(ble_mesh_node_get_neighbor(&node, 0, &neighbor), "Neighbor should be readable");
+    TEST_ASSERT(fabs(neighbor.gps.x - gps.x) <= 0.005 && fabs(neighbor.gps.y - gps.y) <= 0.005 &&
+                fabs(neighbor.gps.z - gps.z) <= 0.005, "GPS should round-trip within 1 cm");
+    TEST_ASSERT(!ble_mesh_node_get_neighbor(&node, 1, &neighbor), "Position past count fails");
+}
+
+void test_wire_format_selection(void)
+{
+    printf("Running test_wire_format_selection...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 80);
+
+    TEST_ASSERT(ble_mesh_node_get_wire_format(&node) == BLE_WIRE_FORMAT_LEGACY,
+                "Default wire format should be legacy");
+
+    ble_mesh_node_set_wire_format(&node, BLE_WIRE_FORMAT_COMPACT);
+    TEST_ASSERT(ble_mesh_node_get_wire_format(&node) == BLE_WIRE_FORMAT_COMPACT,
+                "Wire format should be compact after selecting it");
+
+    ble_mesh_node_init(&node, 81);
+    TEST_ASSERT(ble_mesh_node_get_wire_format(&node) == BLE_WIRE_FORMAT_LEGACY,
+                "Init should restore the legacy wire format");
+}
+
+void test_duplicate_suppression(void)
+{
+    printf("Running test_duplicate_suppression...\n");
+
+    ble_mesh_node_t node;
+    ble_mesh_node_init(&node, 90);
+
+    TEST_ASSERT(!ble_mesh_node_is_duplicate(&node, 12, 1), "First copy is not a duplicate");
+    TEST_ASSERT(ble_mesh_node_is_duplicate(&node, 12, 1), "Second copy is a duplicate");
+
+    // Seen messages expire after two cache generations
+    for (uint32_t i = 0; i < 2 * BLE_DEDUP_DEFAULT_MAX_AGE; i++) {
+        ble_mesh_node_advance_cycle(&node);
+    }
+    TEST_ASSERT(!ble_mesh_node_is_duplicate(&node, 12, 1), "Expired message is not a duplicate");
+
+    TEST_ASSERT(ble_mesh_node_configure_dedup(&node, 50, 0.05, 2), "Valid configuration");
+    TEST_ASSERT(!ble_mesh_node_is_duplicate(&node, 12, 1), "Reconfiguring forgets messages");
+    TEST_ASSERT(!ble_mesh_node_configure_dedup(&node, 0, 0.05, 2), "Invalid configuration");
+}
+
 /* ===== Main Test Runner ===== */
 
 int main(void)
@@ -511,6 +836,15 @@ int main(void)
     test_statistics_updates();
     test_message_counters();
     test_max_neighbors_limit();
+    test_neighbor_index_consistency();
+    test_neighbor_aggregates();
+    test_neighbors_in_range();
+    test_batch_neighbor_ingestion();
+    test_batch_neighbor_capacity();
+    test_append_pdsf();
+    test_neighbor_memory_report();
+    test_wire_format_selection();
+    test_duplicate_suppression();
 
     /* Print results */
     printf("\n========================================\n");
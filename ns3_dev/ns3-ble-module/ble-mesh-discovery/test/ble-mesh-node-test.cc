@@ -192,6 +192,23 @@ BleMeshNodeNeighborTestCase::DoRun (void)
   // Test updating non-existent neighbor
   result = node->UpdateNeighborGps (999, gps);
   NS_TEST_ASSERT_MSG_EQ (result, false, "Updating non-existent neighbor should fail");
+
+  // Repeated GPS updates count the neighbor once
+  node->UpdateNeighborGps (100, gps);
+  NS_TEST_ASSERT_MSG_EQ (node->GetGpsNeighborCount (), 1, "One neighbor should have GPS");
+
+  // Receptions of one slot are applied together at the flush
+  node->QueueNeighborObservation (300, -40, 1);
+  node->QueueNeighborObservation (301, -60, 2, Vector (1.0, 2.0, 0.0));
+  node->QueueNeighborObservation (300, -42, 1);
+  NS_TEST_ASSERT_MSG_EQ (node->GetPendingObservationCount (), 3, "Three receptions queued");
+  NS_TEST_ASSERT_MSG_EQ (node->GetNeighborCount (), 3, "Queued receptions are not applied yet");
+
+  uint16_t stored = node->FlushNeighborObservations ();
+  NS_TEST_ASSERT_MSG_EQ (stored, 3, "All receptions should be stored");
+  NS_TEST_ASSERT_MSG_EQ (node->GetPendingObservationCount (), 0, "Flush empties the queue");
+  NS_TEST_ASSERT_MSG_EQ (node->GetNeighborCount (), 5, "Repeated sender is merged");
+  NS_TEST_ASSERT_MSG_EQ (node->GetGpsNeighborCount (), 2, "GPS reception is applied");
 }
 
 /**
@@ -438,6 +455,61 @@ BleMeshNodePruningTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (node->GetNeighborCount (), 1, "Should have 1 neighbor remaining");
 }
 
+/**
+ * \ingroup ble-mesh-discovery-test
+ * \ingroup tests
+ *
+ * \brief BLE Mesh Node Duplicate Suppression Test
+ */
+class BleMeshNodeDuplicateTestCase : public TestCase
+{
+public:
+  BleMeshNodeDuplicateTestCase ();
+  virtual ~BleMeshNodeDuplicateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BleMeshNodeDuplicateTestCase::BleMeshNodeDuplicateTestCase ()
+  : TestCase ("BLE Mesh Node duplicate suppression test")
+{
+}
+
+BleMeshNodeDuplicateTestCase::~BleMeshNodeDuplicateTestCase ()
+{
+}
+
+void
+BleMeshNodeDuplicateTestCase::DoRun (void)
+{
+  Ptr<BleMeshNodeWrapper> node = CreateObject<BleMeshNodeWrapper> ();
+  node->Initialize (700);
+
+  NS_TEST_ASSERT_MSG_EQ (node->ConfigureDuplicateFilter (100, 0.01, 3), true,
+                         "Valid filter configuration should be accepted");
+  NS_TEST_ASSERT_MSG_EQ (node->ConfigureDuplicateFilter (100, 1.5, 3), false,
+                         "Invalid false-positive rate should be rejected");
+
+  NS_TEST_ASSERT_MSG_EQ (node->IsDuplicateMessage (42, 1), false, "First copy is new");
+  NS_TEST_ASSERT_MSG_EQ (node->IsDuplicateMessage (42, 1), true, "Second copy is a duplicate");
+  NS_TEST_ASSERT_MSG_EQ (node->IsDuplicateMessage (43, 1), false, "Other sender is new");
+
+  // Remembered for at least one generation, forgotten after two
+  for (int i = 0; i < 3; i++)
+    {
+      node->AdvanceCycle ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (node->IsDuplicateMessage (43, 1), true,
+                         "Message should survive one rotation");
+  for (int i = 0; i < 6; i++)
+    {
+      node->AdvanceCycle ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (node->IsDuplicateMessage (42, 1), false,
+                         "Message should expire after two rotations");
+}
+
 /**
  * \ingroup ble-mesh-discovery-test
  * \ingroup tests
@@ -460,6 +532,7 @@ BleMeshNodeTestSuite::BleMeshNodeTestSuite ()
   AddTestCase (new BleMeshNodeStatisticsTestCase, TestCase::QUICK);
   AddTestCase (new BleMeshNodeClusteringTestCase, TestCase::QUICK);
   AddTestCase (new BleMeshNodePruningTestCase, TestCase::QUICK);
+  AddTestCase (new BleMeshNodeDuplicateTestCase, TestCase::QUICK);
 }
 
 static BleMeshNodeTestSuite g_bleMeshNodeTestSuite;
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 KU Leuven
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ * Microbenchmark of a channel hop. Every PHY is attached to the 40
+ * per-index channels, as happens after a while in a simulation, and
+ * random PHYs then hop to random channel indices the way
+ * BleLinkManager::ManageChannelSelection does. The wall clock time per
+ * hop is printed for each number of nodes.
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/ble-module.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BleChannelHopBenchmark");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t maxNodes = 5000; // Largest number of nodes
+  uint32_t hops = 100000; // Number of hops per measurement
+
+  CommandLine cmd;
+  cmd.AddValue ("maxNodes", "Largest number of nodes", maxNodes);
+  cmd.AddValue ("hops", "Number of hops per measurement", hops);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+
+  std::cout << "nodes\tns/hop" << std::endl;
+  std::vector<uint32_t> nodeCounts = {10, 100, 1000, maxNodes};
+  for (uint32_t n : nodeCounts)
+    {
+      std::vector<Ptr<SpectrumChannel> > channels;
+      for (uint32_t i = 0; i < 40; i++)
+        {
+          channels.push_back (CreateObject<MultiModelSpectrumChannel> ());
+        }
+      std::vector<Ptr<BlePhy> > phys;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          Ptr<BlePhy> phy = CreateObject<BlePhy> ();
+          for (auto &channel : channels)
+            {
+              phy->SetChannel (channel);
+            }
+          phys.push_back (phy);
+        }
+
+      std::chrono::steady_clock::time_point start
+        = std::chrono::steady_clock::now ();
+      for (uint32_t i = 0; i < hops; i++)
+        {
+          Ptr<BlePhy> phy = phys[random->GetInteger (0, n - 1)];
+          uint8_t channelIndex = random->GetInteger (0, 36);
+          phy->SetChannel (channels[channelIndex]);
+          phy->SetChannelIndex (channelIndex);
+        }
+      double ns = std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now () - start).count ();
+      std::cout << n << "\t" << std::fixed << std::setprecision (1)
+        << ns / hops << std::endl;
+
+      for (auto &channel : channels)
+        {
+          channel->Dispose ();
+        }
+    }
+  Simulator::Destroy ();
+  return 0;
+}
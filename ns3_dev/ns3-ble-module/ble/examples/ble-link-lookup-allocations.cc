@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 KU Leuven
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ * Counts the heap allocations of link lookups. BleBBManager::GetLink,
+ * BleBBManager::LinkExists, BleLink::GetLinkedDevice and
+ * BleLink::GetLinkedDevices are called repeatedly on a master with a
+ * link to every other node, and none of these calls may allocate.
+ *
+ * The count replaces the global operator new, so it is kept in this
+ * program instead of the test runner. It is listed in
+ * test/examples-to-run.py and returns a non-zero exit code on failure.
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/network-module.h>
+#include <ns3/ble-module.h>
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BleLinkLookupAllocations");
+
+// Number of calls to the global operator new
+static uint64_t g_allocations = 0;
+
+void *
+operator new (std::size_t size)
+{
+  g_allocations++;
+  void *p = std::malloc (size ? size : 1);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void
+operator delete (void *p) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete (void *p, std::size_t size) noexcept
+{
+  std::free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nNodes = 4; // Number of nodes, node 0 is the master
+  uint32_t nLookups = 100; // Number of rounds of lookups
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "Number of nodes", nNodes);
+  cmd.AddValue ("lookups", "Number of rounds of lookups", nLookups);
+  cmd.Parse (argc, argv);
+
+  BleHelper helper;
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  NetDeviceContainer devices = helper.Install (nodes);
+  std::vector<Ptr<BleBBManager> > bbms;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<BleNetDevice> dev = DynamicCast<BleNetDevice> (devices.Get (i));
+      dev->SetAddress (Mac16Address::Allocate ());
+      bbms.push_back (dev->GetBBManager ());
+    }
+  // Node 0 is the master of a link with every other node
+  std::vector<Ptr<BleLink> > links;
+  for (uint32_t i = 1; i < nNodes; i++)
+    {
+      links.push_back (bbms[0]->CreateLink (bbms[i],
+                                            BleLinkManager::Role::MASTER_ROLE));
+    }
+  Mac16Address lastAddress =
+    DynamicCast<BleNetDevice> (devices.Get (nNodes - 1))->GetAddress16 ();
+
+  int result = 0;
+
+  // The counter must see the allocations of this program
+  uint64_t before = g_allocations;
+  delete new int (0);
+  if (g_allocations - before != 1)
+    {
+      std::cerr << "The allocation counter does not work" << std::endl;
+      result = 1;
+    }
+
+  // Build the link index of the baseband manager first
+  if (bbms[0]->GetLink (lastAddress) != links.back ())
+    {
+      std::cerr << "Wrong link to the last node" << std::endl;
+      result = 1;
+    }
+
+  uint32_t members = 0;
+  uint32_t found = 0;
+  before = g_allocations;
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      for (const Ptr<BleLink> &link : links)
+        {
+          for (const Ptr<BleBBManager> &bbm : link->GetLinkedDevices ())
+            {
+              members += (bbm != 0);
+            }
+          found += (link->GetLinkedDevice (lastAddress) != 0);
+        }
+      found += (bbms[0]->GetLink (lastAddress) == links.back ());
+      found += bbms[0]->LinkExists (lastAddress);
+    }
+  uint64_t allocations = g_allocations - before;
+
+  std::cout << "lookups\tallocations" << std::endl;
+  std::cout << nLookups << "\t" << allocations << std::endl;
+
+  if (allocations != 0)
+    {
+      std::cerr << "Link lookups allocated memory" << std::endl;
+      result = 1;
+    }
+  if (members != nLookups * links.size () * 2)
+    {
+      std::cerr << "Wrong number of link members" << std::endl;
+      result = 1;
+    }
+  // The last node is a member of one link, and is found by both
+  // lookups of the master
+  if (found != nLookups * 3)
+    {
+      std::cerr << "Wrong number of address lookups" << std::endl;
+      result = 1;
+    }
+
+  Simulator::Destroy ();
+  return result;
+}
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 KU Leuven
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ * Microbenchmark of BlePhy::StartRx. A single PHY receives bursts of
+ * concurrent signals on the same channel, so every arrival goes through
+ * the co-channel rejection check against all signals already on the air.
+ * The wall clock time per arrival is printed for each number of
+ * concurrent signals.
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/ble-module.h>
+#include <ns3/spectrum-value.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("BlePhyRxBenchmark");
+
+static uint32_t receptions = 0;
+
+static void
+ReceptionEnd (Ptr<Packet> packet, bool error)
+{
+  receptions++;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t maxSignals = 40; // Largest number of concurrent signals
+  uint32_t iterations = 200; // Bursts per number of concurrent signals
+
+  CommandLine cmd;
+  cmd.AddValue ("maxSignals", "Largest number of concurrent signals",
+      maxSignals);
+  cmd.AddValue ("iterations", "Number of bursts per measurement", iterations);
+  cmd.Parse (argc, argv);
+
+  Ptr<BlePhy> phy = CreateObject<BlePhy> ();
+  phy->SetReceptionEndCallback (MakeCallback (&ReceptionEnd));
+  phy->ChangeState (BlePhy::State::RX);
+
+  uint8_t channel = 10;
+  Ptr<UniformRandomVariable> power = CreateObject<UniformRandomVariable> ();
+  power->SetAttribute ("Min", DoubleValue (1e-12));
+  power->SetAttribute ("Max", DoubleValue (1e-9));
+
+  std::cout << "signals\tns/arrival" << std::endl;
+  for (uint32_t n = 1; n <= maxSignals; n = (n < 5) ? n + 1 : n + 5)
+    {
+      std::chrono::steady_clock::duration elapsed
+        = std::chrono::steady_clock::duration::zero ();
+      for (uint32_t i = 0; i < iterations; i++)
+        {
+          // Build the burst upfront, only the arrivals are timed
+          std::vector<Ptr<BleSpectrumSignalParameters> > burst;
+          for (uint32_t s = 0; s < n; s++)
+            {
+              Ptr<SpectrumValue> psd =
+                Create<SpectrumValue> (phy->GetRxSpectrumModel ());
+              (*psd)[channel + 2] = power->GetValue () / 10;
+              (*psd)[channel + 3] = power->GetValue ();
+              (*psd)[channel + 4] = power->GetValue () / 10;
+              Ptr<BleSpectrumSignalParameters> params =
+                Create<BleSpectrumSignalParameters> ();
+              params->psd = psd;
+              params->duration = MicroSeconds (100);
+              params->packet = Create<Packet> (20);
+              params->SetChannel (channel);
+              burst.push_back (params);
+            }
+          phy->ChangeState (BlePhy::State::RX_BUSY);
+          std::chrono::steady_clock::time_point start
+            = std::chrono::steady_clock::now ();
+          for (auto &params : burst)
+            {
+              phy->StartRx (params);
+            }
+          elapsed += std::chrono::steady_clock::now () - start;
+          Simulator::Run ();
+          phy->ChangeState (BlePhy::State::RX);
+        }
+      double ns = std::chrono::duration_cast<std::chrono::nanoseconds>
+        (elapsed).count ();
+      std::cout << n << "\t" << std::fixed << std::setprecision (1)
+        << ns / (n * iterations) << std::endl;
+    }
+  NS_ASSERT (receptions > 0);
+  Simulator::Destroy ();
+  return 0;
+}
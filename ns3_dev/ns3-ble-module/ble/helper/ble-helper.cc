@@ -35,6 +35,7 @@
 #include <ns3/log.h>
 #include "ns3/names.h"
 #include <ns3/random-variable-stream.h>
+#include <ns3/boolean.h>
 #include <ns3/onoff-application.h>
 #include "ns3/applications-module.h"
 #include <ns3/propagation-loss-model.h>
@@ -42,6 +43,11 @@
 #include <ns3/single-model-spectrum-channel.h>
 #include <ns3/spectrum-helper.h>
 #include "ns3/ipv4-global-routing-helper.h"
+#include <ns3/constant-position-mobility-model.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
 namespace ns3 {
 
 
@@ -77,12 +83,81 @@ AsciiBleMacTransmitSinkWithoutContext (
     << " " << *p << std::endl;
 }
 
+/**
+ * @brief Check whether the received power reaches a threshold
+ * @param loss the propagation loss model
+ * @param txPowerDbm the transmit power
+ * @param minRxPowerDbm the threshold
+ * @param txHeight the height of the transmitter
+ * @param rxHeight the height of the receiver
+ * @param horizontal the horizontal distance
+ * @return true if the threshold is reached
+ */
+static bool
+ReachesRxPower (Ptr<PropagationLossModel> loss, double txPowerDbm,
+    double minRxPowerDbm, double txHeight, double rxHeight, double horizontal)
+{
+  // New mobility models for every probe, so that a caching loss model
+  // does not return the power of an earlier distance
+  Ptr<ConstantPositionMobilityModel> tx =
+    CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> rx =
+    CreateObject<ConstantPositionMobilityModel> ();
+  tx->SetPosition (Vector (0.0, 0.0, txHeight));
+  rx->SetPosition (Vector (horizontal, 0.0, rxHeight));
+  return loss->CalcRxPower (txPowerDbm, tx, rx) >= minRxPowerDbm;
+}
+
+/**
+ * @brief Largest distance at which the received power reaches a threshold
+ *
+ * Assumes the loss increases with the distance.
+ *
+ * @param loss the propagation loss model
+ * @param txPowerDbm the transmit power
+ * @param minRxPowerDbm the threshold
+ * @param txHeight the height of the transmitter
+ * @param rxHeight the height of the receiver
+ * @return the distance in meter
+ */
+static double
+MaxLinkDistance (Ptr<PropagationLossModel> loss, double txPowerDbm,
+    double minRxPowerDbm, double txHeight, double rxHeight)
+{
+  const double maxSearchDistance = 1e7;
+  double low = 0.0;
+  double high = 1.0;
+  while (high < maxSearchDistance && ReachesRxPower (loss, txPowerDbm,
+        minRxPowerDbm, txHeight, rxHeight, high))
+    {
+      low = high;
+      high *= 2;
+    }
+  // Bisect to a centimeter
+  while (high - low > 0.01)
+    {
+      double middle = (low + high) / 2;
+      if (ReachesRxPower (loss, txPowerDbm, minRxPowerDbm, txHeight,
+            rxHeight, middle))
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  return std::sqrt (high * high + (txHeight - rxHeight) * (txHeight - rxHeight));
+}
+
 BleHelper::BleHelper (void)
 {
   m_channel = CreateObject<MultiModelSpectrumChannel> ();
 
-  Ptr<LogDistancePropagationLossModel> lossModel = 
-    CreateObject<LogDistancePropagationLossModel> ();
+  // Static nodes reuse their path loss until one of them moves
+  Ptr<CachedPropagationLossModel> lossModel = 
+    CreateObject<CachedPropagationLossModel> ();
+  lossModel->SetLossModel (CreateObject<LogDistancePropagationLossModel> ());
   m_channel->AddPropagationLossModel (lossModel);
 
   Ptr<ConstantSpeedPropagationDelayModel> delayModel = 
@@ -164,8 +239,10 @@ BleHelper::AddMobility (Ptr<BlePhy> phy, Ptr<MobilityModel> m)
 void
 BleHelper::ConstructAllChannels()
 {
+    // One channel models all channel indices, so that the link budget
+    // of a pair of nodes is shared by all of them
     SpectrumChannelHelper channelHelper;
-    channelHelper.SetChannel ("ns3::MultiModelSpectrumChannel");
+    channelHelper.SetChannel ("ns3::BleSpectrumChannel");
     bool nakagami = false;
     if (nakagami)
     {
@@ -181,11 +258,10 @@ BleHelper::ConstructAllChannels()
     }
     channelHelper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
     
-  for (int i=0; i<40; i++)
-  {
-    Ptr<SpectrumChannel> c = channelHelper.Create ();
-    m_allChannels.push_back(c);
-  }
+  Ptr<SpectrumChannel> c = channelHelper.Create ();
+  // Nakagami fading is drawn anew for every signal
+  c->SetAttribute ("CacheLinkBudgets", BooleanValue (!nakagami));
+  m_allChannels.assign (40, c);
 }
 
 NetDeviceContainer
@@ -616,6 +692,142 @@ BleHelper::CreateAllLinks (NetDeviceContainer c,
  
     }
 }
+
+uint32_t
+BleHelper::CreateLinksInRange (NetDeviceContainer c,
+    bool scheduled, uint32_t nbConnInterval,
+    double txPowerDbm, double rxSensitivityDbm,
+    double marginDb, uint32_t maxNeighbors)
+{
+  NS_LOG_FUNCTION (this << scheduled << nbConnInterval << txPowerDbm
+      << rxSensitivityDbm << marginDb << maxNeighbors);
+  uint32_t nDevices = c.GetN ();
+  if (nDevices < 2)
+    {
+      return 0;
+    }
+  Ptr<PropagationLossModel> loss =
+    m_allChannels.front ()->GetPropagationLossModel ();
+  NS_ASSERT_MSG (loss != 0, "The link channels have no propagation loss model");
+  double minRxPowerDbm = rxSensitivityDbm - marginDb;
+
+  std::vector<Ptr<MobilityModel>> mobility (nDevices);
+  double minHeight = 0.0;
+  double maxHeight = 0.0;
+  for (uint32_t i = 0; i < nDevices; i++)
+    {
+      mobility[i] = c.Get (i)->GetNode ()->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility[i] != 0, "Device " << i << " has no mobility model");
+      double height = mobility[i]->GetPosition ().z;
+      minHeight = (i == 0) ? height : std::min (minHeight, height);
+      maxHeight = (i == 0) ? height : std::max (maxHeight, height);
+    }
+
+  // The height changes the loss, so take the largest distance over
+  // the extreme heights
+  double range = 0.0;
+  const double heights[] = {minHeight, maxHeight};
+  for (double txHeight : heights)
+    {
+      for (double rxHeight : heights)
+        {
+          range = std::max (range, MaxLinkDistance (loss, txPowerDbm,
+                minRxPowerDbm, txHeight, rxHeight));
+        }
+    }
+  NS_LOG_INFO ("Links reach at most " << range << " m");
+
+  // Grid of cells as wide as the range: devices in range of each other
+  // are in the same or in adjacent cells
+  double cellSize = std::max (range, 1.0);
+  typedef std::pair<int64_t, int64_t> Cell;
+  std::map<Cell, std::vector<uint32_t>> grid;
+  std::vector<Cell> cells (nDevices);
+  for (uint32_t i = 0; i < nDevices; i++)
+    {
+      Vector position = mobility[i]->GetPosition ();
+      cells[i] = Cell (static_cast<int64_t> (std::floor (position.x / cellSize)),
+          static_cast<int64_t> (std::floor (position.y / cellSize)));
+      grid[cells[i]].push_back (i);
+    }
+
+  // Pairs in range, as (received power, (device, device))
+  typedef std::pair<double, std::pair<uint32_t, uint32_t>> Candidate;
+  std::vector<Candidate> candidates;
+  for (uint32_t i = 0; i < nDevices; i++)
+    {
+      for (int64_t dx = -1; dx <= 1; dx++)
+        {
+          for (int64_t dy = -1; dy <= 1; dy++)
+            {
+              std::map<Cell, std::vector<uint32_t>>::const_iterator cell =
+                grid.find (Cell (cells[i].first + dx, cells[i].second + dy));
+              if (cell == grid.end ())
+                {
+                  continue;
+                }
+              for (uint32_t j : cell->second)
+                {
+                  // Every pair once
+                  if (j <= i)
+                    {
+                      continue;
+                    }
+                  double rxPowerDbm =
+                    loss->CalcRxPower (txPowerDbm, mobility[i], mobility[j]);
+                  if (rxPowerDbm >= minRxPowerDbm)
+                    {
+                      candidates.push_back (Candidate (rxPowerDbm,
+                            std::make_pair (i, j)));
+                    }
+                }
+            }
+        }
+    }
+
+  // With a cap, the strongest pairs come first and a pair is kept only
+  // while both of its devices have room, so no device exceeds the cap
+  std::set<std::pair<uint32_t, uint32_t>> pairs;
+  if (maxNeighbors > 0)
+    {
+      std::sort (candidates.begin (), candidates.end (),
+          [] (const Candidate &a, const Candidate &b)
+          {
+            return a.first > b.first
+              || (a.first == b.first && a.second < b.second);
+          });
+    }
+  std::vector<uint32_t> degree (nDevices, 0);
+  for (const Candidate &candidate : candidates)
+    {
+      uint32_t i = candidate.second.first;
+      uint32_t j = candidate.second.second;
+      if (maxNeighbors > 0
+          && (degree[i] >= maxNeighbors || degree[j] >= maxNeighbors))
+        {
+          continue;
+        }
+      degree[i]++;
+      degree[j]++;
+      pairs.insert (candidate.second);
+    }
+
+  // Same order and offsets as CreateAllLinks
+  uint32_t nbOffset = 0;
+  for (const std::pair<uint32_t, uint32_t> &pair : pairs)
+    {
+      Ptr<BleNetDevice> BleND1 = DynamicCast<BleNetDevice> (c.Get (pair.first));
+      Ptr<BleNetDevice> BleND2 = DynamicCast<BleNetDevice> (c.Get (pair.second));
+      BleND1->GetBBManager()->CreateLinkScheduled(
+          BleND2->GetBBManager(),
+          BleLinkManager::Role::MASTER_ROLE,
+          scheduled, nbOffset, nbConnInterval);
+      nbOffset++;
+    }
+  NS_LOG_INFO ("Created " << pairs.size () << " links between "
+      << nDevices << " devices");
+  return pairs.size ();
+}
 	
 } // namespace ns3
 
@@ -152,6 +152,33 @@ namespace ns3 {
     void CreateAllLinks (NetDeviceContainer c, 
         bool scheduled, uint32_t nbConnInterval);
 
+    /**
+     * \brief Create links only between devices that can hear each other
+     *
+     * Unlike CreateAllLinks, which connects every pair, a link is created
+     * for a pair only if the power predicted by the propagation loss model of
+     * the link channels is at least rxSensitivityDbm - marginDb. A positive
+     * margin keeps pairs just below sensitivity, which fading can still
+     * connect. Candidates are found with a grid of cells as wide as the
+     * largest such distance, so setup is near-linear in the number of
+     * devices. The loss model is assumed to decrease with distance.
+     *
+     * \param c the devices, which must all have a mobility model
+     * \param scheduled schedule the transmit windows of the links
+     * \param nbConnInterval the connection interval, as in CreateAllLinks
+     * \param txPowerDbm the transmit power used for the prediction
+     * \param rxSensitivityDbm the receiver sensitivity
+     * \param marginDb how far below sensitivity a link is still created
+     * \param maxNeighbors if not 0, no device gets more than maxNeighbors
+     *        links: pairs are taken from the strongest down, and a pair is
+     *        skipped once either device has maxNeighbors links
+     * \returns the number of links created
+     */
+    uint32_t CreateLinksInRange (NetDeviceContainer c,
+        bool scheduled, uint32_t nbConnInterval,
+        double txPowerDbm, double rxSensitivityDbm,
+        double marginDb = 0.0, uint32_t maxNeighbors = 0);
+
     /*
      * Setups a broadcast link
      */
@@ -38,6 +38,9 @@
 
 #include <ns3/constants.h>
 
+#include <map>
+#include <unordered_map>
+
 namespace ns3 {
 
   // Classes
@@ -72,7 +75,6 @@ namespace ns3 {
       Ptr<BleNetDevice> GetNetDevice ();
       void SetNetDevice (Ptr<BleNetDevice> netDevice);
       void SetPhy (Ptr<BlePhy> phy);
-      Ptr<DropTailQueue<QueueItem>> GetQueue (void);
 
       Ptr<Packet> GetCurrentPacket();
       void SetCurrentPacket(Ptr<Packet> packet);
@@ -104,13 +106,19 @@ namespace ns3 {
 
       uint32_t CountLinks ();
 
-      void TryAgain();
+      /*
+       * Mark the index from addresses to link managers as outdated.
+       * It is rebuilt on the next lookup. Must be called when the
+       * members or the type of one of the links change.
+       */
+      void InvalidateLinkIndex ();
 
       /*
-       * Checks if there is a new item in the netdevice queue qnd
-       * forwards this item to the right LinkManager's queue.
+       * Enqueues a packet with its MAC header in the queue of the link
+       * manager of the link to destAddr. Returns false if there is no
+       * link to destAddr or if its queue is full.
        */
-      void HandlePacket ();
+      bool EnqueuePacket (Ptr<Packet> packet, Mac16Address destAddr);
 
       /*
        * The link manager that has control over the phy device at the moment
@@ -120,13 +128,54 @@ namespace ns3 {
       void SetActiveLinkManager(Ptr<BleLinkManager> lm);
       Ptr<BleLinkManager> GetActiveLinkManager();
 
+      /*
+       * Schedule the next transmit window of one of the link managers
+       * of this device. The anchor points of all link managers are kept
+       * in one time-ordered structure, with a single simulator event for
+       * the earliest one. Windows at the same time start in the order
+       * they were scheduled.
+       */
+      void ScheduleTransmitWindow (Ptr<BleLinkManager> lm, Time delay);
+
+      /*
+       * Returns the number of transmit windows of all link managers of
+       * this device that were skipped because the radio was busy
+       */
+      uint32_t GetSkippedTransmitWindows ();
+
     private:
+      /*
+       * Start the transmit windows whose anchor point is now,
+       * and schedule the event for the next anchor point
+       */
+      void StartTransmitWindows ();
+
+      /*
+       * Find the first link manager whose link reaches the given address,
+       * the way the list of link managers is scanned.
+       * Returns 0 if there is none.
+       */
+      Ptr<BleLinkManager> FindLinkManager (Mac16Address address);
+      void BuildLinkIndex ();
+
       Ptr<BleNetDevice> m_netDevice;
       std::list<Ptr<BleLinkManager>> m_linkManagers; 
 
+      // Index of m_linkManagers on the address of the linked devices,
+      // and the first broadcast link manager
+      std::unordered_map<uint16_t, Ptr<BleLinkManager>> m_linkIndex;
+      Ptr<BleLinkManager> m_broadcastLinkManager;
+      bool m_linkIndexValid;
+
       // The LinkManager that has control over the device
       // at this moment
       Ptr<BleLinkManager> m_activeLinkManager;
+
+      // Next anchor point of each link manager, and the event
+      // for the earliest one
+      std::multimap<Time, Ptr<BleLinkManager>> m_anchorPoints;
+      EventId m_anchorEvent;
+      bool m_startingTransmitWindows;
  };
 
 }
@@ -19,6 +19,10 @@
  */
 #include "ble-error-model.h"
 #include <ns3/log.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <map>
+#include <tuple>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -34,17 +38,145 @@ BleErrorModel::GetTypeId (void)
 	static TypeId tid = TypeId ("ns3::BleErrorModel")
 		.SetParent<Object> ()
 		.AddConstructor<BleErrorModel> ()
+		.AddAttribute ("UseLookupTable",
+				"Look up the BER in a precomputed table instead of "
+				"evaluating erfc for every SNR.",
+				BooleanValue (true),
+				MakeBooleanAccessor (&BleErrorModel::m_useTable),
+				MakeBooleanChecker ())
+		.AddAttribute ("MinSnrDb",
+				"Lowest SNR (dB) in the lookup table. Lower SNRs are "
+				"evaluated exactly.",
+				DoubleValue (-10),
+				MakeDoubleAccessor (&BleErrorModel::SetMinSnrDb,
+					&BleErrorModel::GetMinSnrDb),
+				MakeDoubleChecker<double> ())
+		.AddAttribute ("MaxSnrDb",
+				"Highest SNR (dB) in the lookup table. Higher SNRs have "
+				"a BER of 0.",
+				DoubleValue (15),
+				MakeDoubleAccessor (&BleErrorModel::SetMaxSnrDb,
+					&BleErrorModel::GetMaxSnrDb),
+				MakeDoubleChecker<double> ())
+		.AddAttribute ("SnrResolutionDb",
+				"SNR step (dB) between two entries of the lookup table.",
+				DoubleValue (0.05),
+				MakeDoubleAccessor (&BleErrorModel::SetSnrResolutionDb,
+					&BleErrorModel::GetSnrResolutionDb),
+				MakeDoubleChecker<double> (1e-6))
 	;
 	return tid;
 }
 
 BleErrorModel::BleErrorModel (void)
+  : m_useTable (true),
+    m_minSnrDb (-10),
+    m_maxSnrDb (15),
+    m_resolutionDb (0.05),
+    m_table (0)
 {
 
 }
 
+void
+BleErrorModel::SetMinSnrDb (double minSnrDb)
+{
+  m_minSnrDb = minSnrDb;
+  m_table = 0;
+}
+
+double
+BleErrorModel::GetMinSnrDb (void) const
+{
+  return m_minSnrDb;
+}
+
+void
+BleErrorModel::SetMaxSnrDb (double maxSnrDb)
+{
+  m_maxSnrDb = maxSnrDb;
+  m_table = 0;
+}
+
+double
+BleErrorModel::GetMaxSnrDb (void) const
+{
+  return m_maxSnrDb;
+}
+
+void
+BleErrorModel::SetSnrResolutionDb (double resolutionDb)
+{
+  m_resolutionDb = resolutionDb;
+  m_table = 0;
+}
+
+double
+BleErrorModel::GetSnrResolutionDb (void) const
+{
+  return m_resolutionDb;
+}
+
+void
+BleErrorModel::LoadTable (void) const
+{
+  typedef std::tuple<double, double, double> TableKey;
+  static std::map<TableKey, std::vector<double> > tables;
+
+  TableKey key (m_minSnrDb, m_maxSnrDb, m_resolutionDb);
+  std::map<TableKey, std::vector<double> >::iterator it = tables.find (key);
+  if (it == tables.end ())
+    {
+      uint32_t size = 
+        (uint32_t) std::ceil ((m_maxSnrDb - m_minSnrDb) / m_resolutionDb) + 1;
+      NS_LOG_INFO ("Building BER table with " << size << " entries from "
+          << m_minSnrDb << " dB to " << m_maxSnrDb << " dB");
+      std::vector<double> table (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          double snrDb = m_minSnrDb + i * m_resolutionDb;
+          table[i] = std::log ((double) GetExactBER (std::pow (10, snrDb / 10)));
+        }
+      it = tables.insert (std::make_pair (key, table)).first;
+    }
+  m_table = &it->second;
+}
+
 long double 
 BleErrorModel::GetBER (double snr) const
+{
+  if (!m_useTable || snr <= 0)
+    {
+      return GetExactBER (snr);
+    }
+  double snrDb = 10 * std::log10 (snr);
+  if (snrDb < m_minSnrDb)
+    {
+      return GetExactBER (snr);
+    }
+  if (snrDb >= m_maxSnrDb)
+    {
+      return 0;
+    }
+  if (m_table == 0)
+    {
+      LoadTable ();
+    }
+  // Interpolate log(BER) linearly between the two closest entries
+  double position = (snrDb - m_minSnrDb) / m_resolutionDb;
+  uint32_t index = (uint32_t) position;
+  if (index + 1 >= m_table->size ())
+    {
+      return std::exp ((*m_table)[m_table->size () - 1]);
+    }
+  double fraction = position - index;
+  double logBer = (*m_table)[index] 
+    + fraction * ((*m_table)[index + 1] - (*m_table)[index]);
+  return std::exp (logBer);
+}
+
+long double 
+BleErrorModel::GetExactBER (double snr) const
 {
   long double z = sqrtl((long double)snr);
 	if (snr > 0)
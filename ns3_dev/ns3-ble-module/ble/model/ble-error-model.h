@@ -22,6 +22,7 @@
 
 
 #include <ns3/object.h>
+#include <vector>
 
 namespace ns3 {
 
@@ -45,15 +46,58 @@ public:
   BleErrorModel (void);
 
   /**
-   * Return BER for given SNR.
+   * Return BER for given SNR. Unless the UseLookupTable attribute is
+   * false, SNRs inside the table range are interpolated from the table.
    *
    * \return bit error rate
    * \param snr SNR expressed as a power ratio (i.e. not in dB)
    */
   long double GetBER (double snr) const;
 
+  /**
+   * Return BER for given SNR, evaluated with erfc instead of the
+   * lookup table.
+   *
+   * \return bit error rate
+   * \param snr SNR expressed as a power ratio (i.e. not in dB)
+   */
+  long double GetExactBER (double snr) const;
+
+  /**
+   * Set the range and resolution of the SNR lookup table. A changed
+   * table is loaded on the next call to GetBER.
+   *
+   * \param minSnrDb lowest SNR in the table (dB)
+   */
+  void SetMinSnrDb (double minSnrDb);
+  double GetMinSnrDb (void) const;
+  /**
+   * \param maxSnrDb highest SNR in the table (dB)
+   */
+  void SetMaxSnrDb (double maxSnrDb);
+  double GetMaxSnrDb (void) const;
+  /**
+   * \param resolutionDb SNR step between table entries (dB)
+   */
+  void SetSnrResolutionDb (double resolutionDb);
+  double GetSnrResolutionDb (void) const;
+
 private:
+  /**
+   * Point m_table to the table that matches the current SNR range and
+   * resolution, building it if no other instance did so before.
+   */
+  void LoadTable (void) const;
 
+  bool m_useTable; //!< look up the BER instead of evaluating erfc
+  double m_minSnrDb; //!< lowest SNR in the table (dB)
+  double m_maxSnrDb; //!< highest SNR in the table (dB)
+  double m_resolutionDb; //!< SNR step between table entries (dB)
+  /**
+   * Natural logarithm of the BER at every table entry, shared by all
+   * instances with the same SNR range and resolution.
+   */
+  mutable const std::vector<double> *m_table;
 };
 
 
@@ -30,6 +30,7 @@
 #include <ns3/drop-tail-queue.h>
 #include <ns3/queue-item.h>
 #include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/boolean.h>
 
 namespace ns3 {
 
@@ -44,6 +45,19 @@ namespace ns3 {
         .SetParent<Object> ()
         .AddConstructor<BleLinkManager> ()
         // Add attributes and tracesources
+        .AddAttribute ("LazyTransmitWindows",
+            "Stop scheduling the transmit windows of a point-to-point "
+            "connection while neither end has data to send. The next "
+            "anchor point is computed when a packet is queued, so the "
+            "connection keeps its anchor points, event counter and "
+            "channels, but idle connections exchange no keep-alive "
+            "packets. On a device with one link, data is sent at the "
+            "same times as without it. When links of a device share "
+            "anchor points, a suspended window does not take the radio, "
+            "so the other links skip fewer windows and may send earlier.",
+            BooleanValue (false),
+            MakeBooleanAccessor (&BleLinkManager::m_lazyTransmitWindows),
+            MakeBooleanChecker ())
         ;
       return tid;
     }
@@ -59,6 +73,10 @@ namespace ns3 {
     m_peerHasMoreData = false;
     m_onePacketSend = false;
     m_lastUnmappedChannelIndex = 0;
+    m_lazyTransmitWindows = false;
+    m_suspended = false;
+    m_peerLinkManager = 0;
+    m_skippedTransmitWindows = 0;
 
     m_broadcastCollisionAvoidance = true;
     m_advSleepCounter = 0;
@@ -84,6 +102,15 @@ namespace ns3 {
     BleLinkManager::DoDispose () {
       NS_LOG_FUNCTION (this);
       m_queue = 0;
+      if (m_peerLinkManager != 0)
+      {
+        m_peerLinkManager->m_peerLinkManager = 0;
+        m_peerLinkManager = 0;
+      }
+      for (Ptr<Packet> &emptyPdu : m_emptyPdus)
+      {
+        emptyPdu = 0;
+      }
     }
 
   BleLinkManager::~BleLinkManager ()
@@ -237,6 +264,8 @@ namespace ns3 {
         link->SetMaster(otherLinkManager->GetBBManager());
         link->SetLinkType(BleLink::LinkType::POINT_TO_POINT);
         otherLinkManager->expectedRole = MASTER_ROLE;
+        this->m_peerLinkManager = PeekPointer (otherLinkManager);
+        otherLinkManager->m_peerLinkManager = this;
       }
       else if (this->expectedRole == MASTER_ROLE)
       {
@@ -244,6 +273,8 @@ namespace ns3 {
         link->SetMaster(this->GetBBManager());
         link->SetLinkType(BleLink::LinkType::POINT_TO_POINT);
         otherLinkManager->expectedRole = SLAVE_ROLE;
+        this->m_peerLinkManager = PeekPointer (otherLinkManager);
+        otherLinkManager->m_peerLinkManager = this;
       }
       else // STANDBY and CONNECTIONLESS can be different,
         // but lets start with connected links 
@@ -606,6 +637,29 @@ namespace ns3 {
       return m_queue;
     }
 
+  bool
+    BleLinkManager::Enqueue (Ptr<QueueItem> item)
+    {
+      NS_LOG_FUNCTION (this);
+      NS_ASSERT(m_queue != 0);
+      bool queued = m_queue->Enqueue (item);
+      if (m_suspended)
+      {
+        Resume ();
+      }
+      if (m_peerLinkManager != 0 && m_peerLinkManager->m_suspended)
+      {
+        m_peerLinkManager->Resume ();
+      }
+      return queued;
+    }
+
+  bool
+    BleLinkManager::IsSuspended (void) const
+    {
+      return m_suspended;
+    }
+
   Ptr<BleBBManager>
     BleLinkManager::GetBBManager (void)
     {
@@ -722,10 +776,65 @@ namespace ns3 {
      BleLinkManager::PrepareNextTransmitWindow ()
      {
        NS_LOG_FUNCTION (this);
-       m_nextWindow = Simulator::Schedule(
-           GetNextTransmitWindowTime(),
-           &BleLinkManager::StartTransmitWindow,
-           this);
+       this->GetBBManager()->ScheduleTransmitWindow (this,
+           GetNextTransmitWindowTime());
+     }
+
+   uint32_t
+     BleLinkManager::GetSkippedTransmitWindows (void)
+     {
+       return m_skippedTransmitWindows;
+     }
+
+   bool
+     BleLinkManager::IsIdle (void)
+     {
+       return m_queue->IsEmpty () && GetCurrentPacket () == 0 
+         && ! GetPeerHasMoreData ();
+     }
+
+   bool
+     BleLinkManager::CanSuspend (void)
+     {
+       // Only a point-to-point link has a single peer to wake up,
+       // both ends need to be idle
+       return m_lazyTransmitWindows && m_peerLinkManager != 0
+         && IsIdle () && m_peerLinkManager->IsIdle ();
+     }
+
+   void
+     BleLinkManager::Suspend (void)
+     {
+       NS_LOG_FUNCTION (this);
+       NS_LOG_INFO (this << " Idle connection, suspending transmit windows,"
+           " my link = " << this->GetAssociatedLink());
+       m_suspended = true;
+       m_suspendedAnchor = Simulator::Now ();
+     }
+
+   void
+     BleLinkManager::Resume (void)
+     {
+       NS_LOG_FUNCTION (this);
+       NS_ASSERT (m_suspended);
+       // Anchor points continue every connection interval
+       // from the first one that was skipped
+       int64_t interval = GetConnInterval ().GetTimeStep ();
+       int64_t elapsed = (Simulator::Now () - m_suspendedAnchor).GetTimeStep ();
+       int64_t skipped = (elapsed + interval - 1) / interval;
+       Time nextAnchor = m_suspendedAnchor + TimeStep (skipped * interval);
+
+       // Each skipped window would have been a connection event 
+       // and a channel hop
+       m_connEventCounter += static_cast<uint16_t> (skipped);
+       m_lastUnmappedChannelIndex = (m_lastUnmappedChannelIndex 
+           + (skipped % 37) * m_hopIncrement) % 37;
+       m_suspended = false;
+
+       NS_LOG_INFO (this << " Resuming transmit windows after " << skipped
+           << " skipped, next anchor point at " << nextAnchor.GetSeconds ());
+       this->GetBBManager()->ScheduleTransmitWindow (this,
+           nextAnchor - Simulator::Now ());
      }
 
   bool 
@@ -833,19 +942,8 @@ namespace ns3 {
                //   - If I don't answer, connection can be considered lost
                //   - I need to ack received packet
                {
-                 BleMacHeader bmh2;
-                 Ptr<Packet> dummyPacket = Create<Packet> ();
-                 bmh2.SetLength(0);
-                 bmh2.SetLLID(0b01);
-                 bmh2.SetMD(0);
                  this->SetMyLastMD(! m_queue->IsEmpty ());
-                 bmh2.SetNESN(m_nextExpectedSequenceNumber);
-                 bmh2.SetSN(m_sequenceNumber);
-                 bmh2.SetSrcAddr(
-                     this->GetBBManager()->GetNetDevice()->GetAddress16());
-                 bmh2.SetDestAddr(Mac16Address("FF:FF"));
-                 dummyPacket->AddHeader(bmh2);
-                 SetCurrentPacket (dummyPacket);
+                 SetCurrentPacket (GetEmptyPdu ());
                  m_onePacketSend = true;
                }
                else
@@ -880,6 +978,28 @@ namespace ns3 {
        }
      }
 
+   Ptr<Packet>
+     BleLinkManager::GetEmptyPdu ()
+     {
+       Ptr<Packet> &emptyPdu = 
+         m_emptyPdus[m_sequenceNumber * 2 + m_nextExpectedSequenceNumber];
+       if (emptyPdu == 0)
+       {
+         BleMacHeader bmh2;
+         emptyPdu = Create<Packet> ();
+         bmh2.SetLength(0);
+         bmh2.SetLLID(0b01);
+         bmh2.SetMD(0);
+         bmh2.SetNESN(m_nextExpectedSequenceNumber);
+         bmh2.SetSN(m_sequenceNumber);
+         bmh2.SetSrcAddr(
+             this->GetBBManager()->GetNetDevice()->GetAddress16());
+         bmh2.SetDestAddr(Mac16Address("FF:FF"));
+         emptyPdu->AddHeader(bmh2);
+       }
+       return emptyPdu;
+     }
+
    void
      BleLinkManager::HandleTXDone ()
      {
@@ -916,6 +1036,15 @@ namespace ns3 {
        // wait for packet from master to arrive
 
        NS_LOG_FUNCTION (this);
+       if (CanSuspend ())
+       {
+         Suspend ();
+         return;
+       }
+       // Every window is a connection event, whether or not it gets the
+       // radio. Resume () adds the suspended ones, so the counter is the
+       // same with and without lazy transmit windows.
+       m_connEventCounter++;
        if ( this->GetBBManager()->GetActiveLinkManager() == 0)
        {
          this->GetBBManager()->SetActiveLinkManager(this);
@@ -1008,6 +1137,7 @@ namespace ns3 {
              ->IsInsideLastTransmitWindow(Simulator::Now()));
 
          // Callback management 
+         m_skippedTransmitWindows++;
          this->GetBBManager()->GetNetDevice()->NotifyTXWindowSkipped();
 
          SetLastTransmitWindowTime(Simulator::Now());
@@ -70,6 +70,7 @@ namespace ns3 {
     {
       NS_LOG_FUNCTION (this);
       currentLinkType = linkType;
+      NotifyLinkChanged ();
     }
 
   void
@@ -81,7 +82,7 @@ namespace ns3 {
       // //if time allows / in the future: 
       //    change this way of setting channel)
 
-      for (auto v : this->GetLinkedDevices()) // Devices are BBM
+      for (const Ptr<BleBBManager> &v : m_linkedDevices) // Devices are BBM
       {
         v->GetPhy()->SetChannel(c);
       }
@@ -99,19 +100,35 @@ namespace ns3 {
     BleLink::AddSlave(Ptr<BleBBManager> bleBBManager)
     {
       NS_ASSERT (bleBBManager != 0);
-      m_slaves.push_back(bleBBManager);
+      // Keep the master at the end
+      std::vector<Ptr<BleBBManager>>::iterator pos = m_linkedDevices.end();
+      if (m_master != 0)
+      {
+        --pos;
+      }
+      m_linkedDevices.insert(pos, bleBBManager);
+      NotifyLinkChanged ();
     }
 
   void
     BleLink::SetMaster(Ptr<BleBBManager> bleBBManager)
     {
       NS_ASSERT (bleBBManager != 0);
-      // If there already is a master, make that master a slave
-      if (m_master != 0)
+      // If there already is a master, make that master a slave. It is
+      // already at the end of the slaves.
+      m_master = bleBBManager;
+      m_linkedDevices.push_back(bleBBManager);
+      NotifyLinkChanged ();
+    }
+
+  void
+    BleLink::NotifyLinkChanged ()
+    {
+      // The address lookups of the linked devices may change
+      for (const Ptr<BleBBManager> &v : m_linkedDevices)
       {
-        this->AddSlave(m_master);
+        v->InvalidateLinkIndex();
       }
-      m_master = bleBBManager;
     }
 
   Ptr<BleBBManager>
@@ -121,26 +138,19 @@ namespace ns3 {
       return m_master;
     }
 
-  std::list<Ptr<BleBBManager>>
-    BleLink::GetLinkedDevices ()
+  const std::vector<Ptr<BleBBManager>> &
+    BleLink::GetLinkedDevices () const
     {
-      std::list<Ptr<BleBBManager>> all_devices = m_slaves;
-      all_devices.push_back(m_master);
-      
-   //   for (auto v : all_devices)
-   //     std::cout << v << "\n";
-      
-      return all_devices;
+      return m_linkedDevices;
     }
 
   Ptr<BleBBManager>
     BleLink::GetLinkedDevice (Mac16Address addr)
     {
       NS_LOG_FUNCTION (this);
-      for (Ptr<BleBBManager> v : GetLinkedDevices () )
+      for (const Ptr<BleBBManager> &v : m_linkedDevices)
       {
-        Ptr<BleNetDevice> nd = v->GetNetDevice();
-        Mac16Address ndAddress = nd->GetAddress16();
+        Mac16Address ndAddress = v->GetNetDevice()->GetAddress16();
         if (ndAddress == addr)  
         {
           return v;
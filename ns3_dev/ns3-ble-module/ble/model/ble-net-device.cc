@@ -139,11 +139,6 @@ namespace ns3 {
     this->SetLinkController(CreateObject<BleLinkController> ());
     this->GetLinkController()->SetNetDevice(nd_pointer);
 
-    Ptr<DropTailQueue<QueueItem>> packetQueue = 
-      Create<DropTailQueue<QueueItem>> ();
-    packetQueue->SetMaxSize( QueueSize (QUEUE_SIZE_PACKETS));
-    this->SetQueue(packetQueue);
-
     //NS_LOG_INFO ("BleNetDevice constructor done");
 	}
 
@@ -156,7 +151,6 @@ namespace ns3 {
 		BleNetDevice::DoDispose ()
 		{
 			NS_LOG_FUNCTION (this);
-			m_queue = 0;
 			m_node = 0;
 			m_phy = 0;
 			m_rxCallback = MakeNullCallback <bool, 
@@ -206,15 +200,6 @@ namespace ns3 {
 		}
 
 
-	void
-		BleNetDevice::SetQueue (Ptr<DropTailQueue<QueueItem>> q)
-		{
-			NS_LOG_FUNCTION (this);
-			NS_LOG_FUNCTION (q);
-			m_queue = q;
-		}
-
-
 	void
 		BleNetDevice::SetAddress (Address address)
 		{
@@ -444,22 +429,11 @@ namespace ns3 {
       packet->AddHeader (header);
 			
       bool sendOk = true;
-			// If the device is idle, transmission starts immediately. Otherwise,
-			// the transmission will be started by NotifyTransmissionEnd
+      // The destination is known here, the packet goes straight to the
+      // queue of the link manager of that link
       NS_LOG_LOGIC ("Enqueueing new packet of length " << packet->GetSize());
-      Simulator::ScheduleNow(&BleBBManager::TryAgain,
-         this->GetBBManager());
-      NS_ASSERT(m_queue !=0);
       NS_ASSERT(packet !=0);
-      Ptr<QueueItem> item = Create<QueueItem> (packet);
-      NS_ASSERT(item !=0);
-      NS_LOG_INFO ("Max size of queue = " << m_queue->GetMaxSize());
-      NS_LOG_INFO ("Current size of queue = " << m_queue->GetCurrentSize());
-      NS_LOG_INFO ("Size of packet item = " << item->GetSize());
-     // std::cout << std::endl;
-     // packet->Print(std::cout);
-     // std::cout << std::endl;
-      if (m_queue->Enqueue (Create<QueueItem> (packet)) == false)
+      if (this->GetBBManager()->EnqueuePacket (packet, dest16) == false)
       {
           NS_LOG_LOGIC ("Enqueueing new packet failed");
           m_macTxDropTrace (packet);
@@ -517,18 +491,10 @@ namespace ns3 {
       this->m_linkController = linkController;
     }
 
-  Ptr<DropTailQueue<QueueItem>>
-  BleNetDevice::GetQueue (void)
-  {
-    NS_LOG_FUNCTION_NOARGS ();
-    return m_queue;
-  }
-
 	void
 		BleNetDevice::NotifyTransmissionEnd (Ptr<const Packet>)
 		{
 			NS_LOG_FUNCTION (this);
-			NS_ASSERT (m_queue);
 		}
 
     void
@@ -616,8 +582,6 @@ namespace ns3 {
                 m_rxCallback (nd_pointer, packet_copy, protocol, src_addr);
                 m_promiscRxCallback (nd_pointer, packet_copy, 
                     protocol, src_addr, dest_addr, packetType);
-				Simulator::ScheduleNow(&BleBBManager::TryAgain, 
-                    this->GetBBManager());
 			}
 			else // Received packet is not for me
 			{
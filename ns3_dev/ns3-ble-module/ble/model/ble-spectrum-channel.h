@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 KU Leuven
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef BLE_SPECTRUM_CHANNEL_H
+#define BLE_SPECTRUM_CHANNEL_H
+
+#include <ns3/spectrum-channel.h>
+#include <ns3/nstime.h>
+#include <ns3/course-change-tracker.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+class BlePhy;
+
+/**
+ * \ingroup BLE
+ *
+ * Spectrum channel carrying all 40 BLE RF channels. A signal is only
+ * delivered to the BlePhys tuned to its channel index or to an index
+ * close enough to receive part of its power. BlePhys are kept per channel
+ * index, so a transmission only visits the PHYs of these indices. The
+ * link budget of a pair of PHYs is computed once and reused by every
+ * channel index, until one of both mobility models notifies a course
+ * change.
+ *
+ * All PHYs must use spectrum models with the same bands, as the BLE
+ * power spectral density is delivered without conversion.
+ */
+class BleSpectrumChannel : public SpectrumChannel
+{
+public:
+  /**
+   * Get the type ID.
+   *
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  BleSpectrumChannel (void);
+  virtual ~BleSpectrumChannel (void);
+
+  // inherited from SpectrumChannel
+  virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+
+  // inherited from Channel
+  virtual std::size_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+  /**
+   * Move a receiver to the PHYs of its new channel index. Called by a
+   * BlePhy when it tunes to another channel index.
+   *
+   * \param phy the receiver
+   */
+  void ChannelIndexChanged (Ptr<const BlePhy> phy);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * A receiver of the channel
+   */
+  struct Receiver
+  {
+    Ptr<SpectrumPhy> m_phy; //!< the receiver
+    Ptr<BlePhy> m_blePhy; //!< the receiver, if it is a BlePhy
+    uint8_t m_channelIndex; //!< channel index of its bucket, for a BlePhy
+    std::size_t m_bucketPosition; //!< position in its bucket, for a BlePhy
+  };
+
+  /**
+   * Link budget of a pair of PHYs
+   */
+  struct LinkBudget
+  {
+    double m_txAntennaGainDb; //!< gain of the transmit antenna
+    double m_rxAntennaGainDb; //!< gain of the receive antenna
+    double m_propagationGainDb; //!< gain of the propagation loss model
+    double m_pathLossDb; //!< total path loss
+    Time m_delay; //!< propagation delay
+    uint64_t m_txEpoch; //!< epoch of the transmitter
+    uint64_t m_rxEpoch; //!< epoch of the receiver
+  };
+
+  /**
+   * Hash of a pair of PHYs
+   */
+  struct PhyPairHash
+  {
+    std::size_t operator() (const std::pair<const SpectrumPhy *,
+        const SpectrumPhy *> &pair) const;
+  };
+
+  /**
+   * Compute the link budget between two PHYs, or take it from the cache
+   * if none of them moved since it was computed.
+   *
+   * \param params the transmitted signal
+   * \param txMobility the mobility model of the transmitter
+   * \param rxPhy the receiver
+   * \param rxMobility the mobility model of the receiver
+   *
+   * \return the link budget
+   */
+  LinkBudget GetLinkBudget (Ptr<SpectrumSignalParameters> params,
+      Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> rxPhy,
+      Ptr<MobilityModel> rxMobility);
+
+  /**
+   * Add a BlePhy receiver to the bucket of its channel index
+   *
+   * \param index the position of the receiver in m_receivers
+   */
+  void AddToBucket (uint32_t index);
+
+  /**
+   * Used internally to reschedule transmission after the propagation delay.
+   *
+   * \param params The signal parameters.
+   * \param receiver A pointer to the receiver SpectrumPhy.
+   */
+  void StartRx (Ptr<SpectrumSignalParameters> params,
+      Ptr<SpectrumPhy> receiver);
+
+  std::vector<Receiver> m_receivers; //!< the receivers of the channel
+  /**
+   * Position in m_receivers per receiver
+   */
+  std::unordered_map<const SpectrumPhy *, uint32_t> m_receiverIndices;
+  /**
+   * Positions in m_receivers of the BlePhys per channel index
+   */
+  std::vector<std::vector<uint32_t> > m_buckets;
+  /**
+   * Positions in m_receivers of the receivers that are no BlePhy,
+   * they get every signal
+   */
+  std::vector<uint32_t> m_otherReceivers;
+  /**
+   * Receivers visited by the current transmission
+   */
+  std::vector<uint32_t> m_visited;
+  CourseChangeTracker m_tracker; //!< epochs of the mobility models
+  /**
+   * Cached link budgets per (transmitter, receiver)
+   */
+  std::unordered_map<std::pair<const SpectrumPhy *, const SpectrumPhy *>,
+    LinkBudget, PhyPairHash> m_linkBudgets;
+  uint32_t m_adjacentChannels; //!< reach of a signal in channel indices
+  bool m_cacheLinkBudgets; //!< reuse link budgets of static pairs
+  uint32_t m_linkBudgetCacheSize; //!< maximum number of cached budgets
+};
+
+} // namespace ns3
+
+#endif /* BLE_SPECTRUM_CHANNEL_H */
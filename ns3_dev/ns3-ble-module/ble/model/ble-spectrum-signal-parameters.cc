@@ -34,6 +34,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("BleSpectrumSignalParameters");
 
 BleSpectrumSignalParameters::BleSpectrumSignalParameters (void)
+  : m_rxPower (-1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -45,6 +46,8 @@ BleSpectrumSignalParameters::BleSpectrumSignalParameters (
   NS_LOG_FUNCTION (this << &p);
   packet = p.packet->Copy ();
   m_channel = p.m_channel;
+  // The copy gets its own psd on its way to a receiver
+  m_rxPower = -1;
 }
 
 BleSpectrumSignalParameters::~BleSpectrumSignalParameters (void)
@@ -101,4 +104,16 @@ BleSpectrumSignalParameters::GetEvent (void)
 {
   return m_event;
 }
+
+void
+BleSpectrumSignalParameters::SetRxPower (double power)
+{
+  m_rxPower = power;
+}
+
+double
+BleSpectrumSignalParameters::GetRxPower (void) const
+{
+  return m_rxPower;
+}
 } // namespace ns3
@@ -43,6 +43,7 @@
 #include <ns3/trace-helper.h>
 #include <ns3/drop-tail-queue.h>
 #include <unordered_map>
+#include <set>
 #include "ns3/network-module.h"
 #include "ns3/csma-module.h"
 #include "ns3/internet-module.h"
@@ -215,6 +216,14 @@ BleTestCase2::DoRun (void)
       DynamicCast<BleNetDevice>(bleNetDevices.Get(0))->GetBBManager()->LinkExists(
         DynamicCast<BleNetDevice>(bleNetDevices.Get(1))->GetAddress16()), 
       true, "Dev0 has no link to the address of dev1");
+  NS_TEST_ASSERT_MSG_EQ (
+      DynamicCast<BleNetDevice>(bleNetDevices.Get(0))->GetBBManager()->GetLink(
+        DynamicCast<BleNetDevice>(bleNetDevices.Get(1))->GetAddress16()), 
+      link2, "The link to the address of dev1 is not link 2");
+  NS_TEST_ASSERT_MSG_EQ (
+      DynamicCast<BleNetDevice>(bleNetDevices.Get(0))->GetBBManager()->LinkExists(
+        Mac16Address ("FF:FF")), 
+      false, "Dev0 has a broadcast link, but none was created");
 
   // At this point, creating a link at startup works, let's try to create a link 
   // during simulation.
@@ -698,6 +707,792 @@ BleTestCase4::DoRun (void)
 
 
 
+// Looking up links and their members must not copy them. The allocations
+// of these lookups are counted by examples/ble-link-lookup-allocations.cc
+class BleTestCaseLinkLookup : public TestCase
+{
+public:
+  BleTestCaseLinkLookup ();
+  virtual ~BleTestCaseLinkLookup ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BleTestCaseLinkLookup::BleTestCaseLinkLookup ()
+  : TestCase ("Ble test case looks up links without copying")
+{
+}
+
+BleTestCaseLinkLookup::~BleTestCaseLinkLookup ()
+{
+}
+
+void
+BleTestCaseLinkLookup::DoRun (void)
+{
+  uint32_t nNodes = 4;
+  uint32_t nLookups = 100;
+
+  BleHelper helper;
+  NodeContainer bleDeviceNodes;
+  bleDeviceNodes.Create(nNodes);
+  NetDeviceContainer bleNetDevices = helper.Install (bleDeviceNodes);
+  std::vector<Ptr<BleBBManager>> bbms;
+  for (uint32_t i = 0; i < nNodes; i++)
+  {
+    Ptr<BleNetDevice> dev = DynamicCast<BleNetDevice>(bleNetDevices.Get(i));
+    dev->SetAddress (Mac16Address::Allocate ());
+    bbms.push_back (dev->GetBBManager());
+  }
+  // Node 0 is the master of a link with every other node
+  std::vector<Ptr<BleLink>> links;
+  for (uint32_t i = 1; i < nNodes; i++)
+  {
+    links.push_back (bbms[0]->CreateLink (bbms[i],
+          BleLinkManager::Role::MASTER_ROLE));
+  }
+  Mac16Address lastAddress =
+    DynamicCast<BleNetDevice>(bleNetDevices.Get(nNodes - 1))->GetAddress16();
+
+  // Build the link index of the baseband manager first
+  NS_TEST_ASSERT_MSG_EQ (bbms[0]->GetLink (lastAddress), links.back(),
+      "Wrong link to the last node");
+
+  // The members are returned by reference to the storage of the link,
+  // so repeated lookups do not build a new container
+  std::vector<const Ptr<BleBBManager> *> storage;
+  for (const Ptr<BleLink> &link : links)
+  {
+    storage.push_back (link->GetLinkedDevices ().data ());
+  }
+  uint32_t members = 0;
+  uint32_t found = 0;
+  bool sameStorage = true;
+  for (uint32_t i = 0; i < nLookups; i++)
+  {
+    for (uint32_t l = 0; l < links.size(); l++)
+    {
+      const std::vector<Ptr<BleBBManager>> &linked =
+        links[l]->GetLinkedDevices ();
+      sameStorage = sameStorage && linked.data () == storage[l]
+        && &linked == &links[l]->GetLinkedDevices ();
+      for (const Ptr<BleBBManager> &bbm : linked)
+      {
+        members += (bbm != 0);
+      }
+      found += (links[l]->GetLinkedDevice (lastAddress) != 0);
+    }
+    found += (bbms[0]->GetLink (lastAddress) == links.back());
+    found += bbms[0]->LinkExists (lastAddress);
+  }
+
+  NS_TEST_ASSERT_MSG_EQ (sameStorage, true,
+      "Link members are not returned from the storage of the link");
+  NS_TEST_ASSERT_MSG_EQ (members, nLookups * links.size() * 2,
+      "Every link has a master and a slave");
+  NS_TEST_ASSERT_MSG_EQ (found, nLookups * 3,
+      "The last node is found in one link and in the link index");
+
+  // The master stays at the end of the members
+  links.front()->AddSlave (bbms[2]);
+  const std::vector<Ptr<BleBBManager>> &devices =
+    links.front()->GetLinkedDevices ();
+  NS_TEST_ASSERT_MSG_EQ (devices.size(), 3, "Wrong number of members");
+  NS_TEST_ASSERT_MSG_EQ (devices.back(), links.front()->GetMaster(),
+      "The master is not the last member");
+
+  Simulator::Destroy ();
+}
+
+
+
+// Links are only created between devices that can hear each other
+class BleTestCaseLinksInRange : public TestCase
+{
+public:
+  BleTestCaseLinksInRange ();
+  virtual ~BleTestCaseLinksInRange ();
+
+private:
+  virtual void DoRun (void);
+  bool Linked (NetDeviceContainer devices, uint32_t i, uint32_t j);
+};
+
+BleTestCaseLinksInRange::BleTestCaseLinksInRange ()
+  : TestCase ("Ble test case creates links only between devices in range")
+{
+}
+
+BleTestCaseLinksInRange::~BleTestCaseLinksInRange ()
+{
+}
+
+bool
+BleTestCaseLinksInRange::Linked (NetDeviceContainer devices,
+    uint32_t i, uint32_t j)
+{
+  Ptr<BleNetDevice> dev1 = DynamicCast<BleNetDevice>(devices.Get(i));
+  Ptr<BleNetDevice> dev2 = DynamicCast<BleNetDevice>(devices.Get(j));
+  return dev1->GetBBManager()->LinkExists (dev2->GetAddress16())
+    && dev2->GetBBManager()->LinkExists (dev1->GetAddress16());
+}
+
+void
+BleTestCaseLinksInRange::DoRun (void)
+{
+  uint32_t nLine = 12;
+  uint32_t nField = 60;
+  double spacing = 20.0;
+  double length = 200.0;
+  double txPowerDbm = 10.0;
+
+  // The helper's link channels use this loss model
+  Ptr<OkumuraHataPropagationLossModel> loss =
+    CreateObject<OkumuraHataPropagationLossModel> ();
+  loss->SetAttribute ("Frequency", DoubleValue (2400e6));
+  Ptr<ConstantPositionMobilityModel> a =
+    CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b =
+    CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0.0, 0.0, 1.0));
+  b->SetPosition (Vector (2.5 * spacing, 0.0, 1.0));
+  // Devices on the line reach the next two devices
+  double sensitivityDbm = loss->CalcRxPower (txPowerDbm, a, b);
+
+  // Devices on a line, with two links each only the next device is linked
+  for (uint32_t maxNeighbors : {0u, 2u})
+  {
+    BleHelper helper;
+    NodeContainer nodes;
+    nodes.Create (nLine);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions =
+      CreateObject<ListPositionAllocator> ();
+    for (uint32_t i = 0; i < nLine; i++)
+    {
+      positions->Add (Vector (i * spacing, 0.0, 1.0));
+    }
+    mobility.SetPositionAllocator (positions);
+    mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+    mobility.Install (nodes);
+    NetDeviceContainer devices = helper.Install (nodes);
+
+    uint32_t created = helper.CreateLinksInRange (devices, true, 0,
+        txPowerDbm, sensitivityDbm, 0.0, maxNeighbors);
+    uint32_t reach = (maxNeighbors == 0) ? 2 : 1;
+    NS_TEST_ASSERT_MSG_EQ (created, (nLine - 1) + (reach == 2 ? nLine - 2 : 0),
+        "Wrong number of links on the line");
+    bool match = true;
+    for (uint32_t i = 0; i < nLine; i++)
+    {
+      for (uint32_t j = i + 1; j < nLine; j++)
+      {
+        match = match && Linked (devices, i, j) == (j - i <= reach);
+      }
+    }
+    NS_TEST_ASSERT_MSG_EQ (match, true,
+        "Devices on the line are linked to the wrong neighbors");
+    Simulator::Destroy ();
+  }
+
+  // Devices spread over a field match a check of every pair
+  {
+    BleHelper helper;
+    NodeContainer nodes;
+    nodes.Create (nField);
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+    random->SetStream (7);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions =
+      CreateObject<ListPositionAllocator> ();
+    for (uint32_t i = 0; i < nField; i++)
+    {
+      positions->Add (Vector (random->GetValue (-length, length),
+            random->GetValue (-length, length), 1.0));
+    }
+    mobility.SetPositionAllocator (positions);
+    mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+    mobility.Install (nodes);
+    NetDeviceContainer devices = helper.Install (nodes);
+
+    double marginDb = 3.0;
+    uint32_t created = helper.CreateLinksInRange (devices, true, 0,
+        txPowerDbm, sensitivityDbm, marginDb);
+    uint32_t expected = 0;
+    bool match = true;
+    for (uint32_t i = 0; i < nField; i++)
+    {
+      for (uint32_t j = i + 1; j < nField; j++)
+      {
+        bool inRange = loss->CalcRxPower (txPowerDbm,
+            nodes.Get(i)->GetObject<MobilityModel> (),
+            nodes.Get(j)->GetObject<MobilityModel> ())
+          >= sensitivityDbm - marginDb;
+        expected += inRange;
+        match = match && Linked (devices, i, j) == inRange;
+      }
+    }
+    NS_TEST_ASSERT_MSG_EQ (created, expected, "Wrong number of links");
+    NS_TEST_ASSERT_MSG_GT (expected, 0u, "The field has no devices in range");
+    NS_TEST_ASSERT_MSG_LT (expected, nField * (nField - 1) / 2,
+        "The field has no devices out of range");
+    NS_TEST_ASSERT_MSG_EQ (match, true, "Links differ from a check of every pair");
+    Simulator::Destroy ();
+  }
+
+  // Spokes around a hub are all closest to the hub, the cap still holds
+  // at the hub and at every spoke
+  {
+    uint32_t nSpokes = 5;
+    uint32_t maxNeighbors = 2;
+    BleHelper helper;
+    NodeContainer nodes;
+    nodes.Create (nSpokes + 1);
+    MobilityHelper mobility;
+    Ptr<ListPositionAllocator> positions =
+      CreateObject<ListPositionAllocator> ();
+    positions->Add (Vector (0.0, 0.0, 1.0));
+    for (uint32_t i = 0; i < nSpokes; i++)
+    {
+      double angle = 2 * M_PI * i / nSpokes;
+      positions->Add (Vector (spacing * std::cos (angle),
+            spacing * std::sin (angle), 1.0));
+    }
+    mobility.SetPositionAllocator (positions);
+    mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+    mobility.Install (nodes);
+    NetDeviceContainer devices = helper.Install (nodes);
+
+    uint32_t created = helper.CreateLinksInRange (devices, true, 0,
+        txPowerDbm, sensitivityDbm, 0.0, maxNeighbors);
+    std::vector<uint32_t> degree (nSpokes + 1, 0);
+    uint32_t linked = 0;
+    for (uint32_t i = 0; i <= nSpokes; i++)
+    {
+      for (uint32_t j = i + 1; j <= nSpokes; j++)
+      {
+        if (Linked (devices, i, j))
+        {
+          degree[i]++;
+          degree[j]++;
+          linked++;
+        }
+      }
+    }
+    NS_TEST_ASSERT_MSG_EQ (created, linked, "Wrong number of links");
+    NS_TEST_ASSERT_MSG_EQ (degree[0], maxNeighbors,
+        "The hub does not have exactly the capped number of links");
+    bool capped = true;
+    for (uint32_t i = 1; i <= nSpokes; i++)
+    {
+      capped = capped && degree[i] >= 1 && degree[i] <= maxNeighbors;
+    }
+    NS_TEST_ASSERT_MSG_EQ (capped, true,
+        "A spoke is unlinked or has more links than the cap");
+    Simulator::Destroy ();
+  }
+}
+
+
+
+// Creates n static nodes 5 m apart on a line and installs BLE devices
+static NetDeviceContainer
+InstallLine (BleHelper &helper, NodeContainer &nodes, uint32_t n)
+{
+  nodes.Create (n);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < n; i++)
+  {
+    positions->Add (Vector (5.0 * i, 0.0, 1.0));
+  }
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  return helper.Install (nodes);
+}
+
+
+
+// Idle connections skip their transmit windows, but data is still sent
+// at the same anchor points and on the same channels
+class BleTestCaseLazyTransmitWindows : public TestCase
+{
+public:
+  BleTestCaseLazyTransmitWindows ();
+  virtual ~BleTestCaseLazyTransmitWindows ();
+
+private:
+  virtual void DoRun (void);
+  void Run (bool lazy);
+  void Send (Ptr<BleNetDevice> from, Mac16Address to);
+  void Received (Ptr<const Packet> packet);
+
+  Ptr<BleLinkManager> m_receiverLinkManager;
+  std::vector<Time> m_rxTimes;
+  std::vector<uint8_t> m_rxChannels;
+  std::vector<uint16_t> m_rxEventCounters;
+  uint64_t m_events;
+  bool m_suspendedAtEnd;
+};
+
+BleTestCaseLazyTransmitWindows::BleTestCaseLazyTransmitWindows ()
+  : TestCase ("Ble test case suspends the transmit windows of idle links")
+{
+}
+
+BleTestCaseLazyTransmitWindows::~BleTestCaseLazyTransmitWindows ()
+{
+}
+
+void
+BleTestCaseLazyTransmitWindows::Send (Ptr<BleNetDevice> from, Mac16Address to)
+{
+  from->Send (Create<Packet> (20), to, 0);
+}
+
+void
+BleTestCaseLazyTransmitWindows::Received (Ptr<const Packet> packet)
+{
+  m_rxTimes.push_back (Simulator::Now ());
+  m_rxChannels.push_back (m_receiverLinkManager->GetCurrentChannelIndex ());
+  m_rxEventCounters.push_back (m_receiverLinkManager->GetConnEventCounter ());
+}
+
+void
+BleTestCaseLazyTransmitWindows::Run (bool lazy)
+{
+  Config::SetDefault ("ns3::BleLinkManager::LazyTransmitWindows",
+      BooleanValue (lazy));
+  m_rxTimes.clear ();
+  m_rxChannels.clear ();
+  m_rxEventCounters.clear ();
+
+  BleHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = InstallLine (helper, nodes, 2);
+  // Connection interval of 100 ms
+  helper.CreateAllLinks (devices, true, 80);
+
+  Ptr<BleNetDevice> dev0 = DynamicCast<BleNetDevice>(devices.Get(0));
+  Ptr<BleNetDevice> dev1 = DynamicCast<BleNetDevice>(devices.Get(1));
+  Ptr<BleLinkManager> senderLinkManager =
+    dev0->GetBBManager()->GetLinkManager (dev1->GetAddress16());
+  m_receiverLinkManager =
+    dev1->GetBBManager()->GetLinkManager (dev0->GetAddress16());
+  // The channel map is drawn randomly, use the same one in both runs
+  std::vector<uint8_t> channels = {3, 8, 14, 21, 30};
+  senderLinkManager->SetUsedChannels (channels);
+  m_receiverLinkManager->SetUsedChannels (channels);
+  dev1->TraceConnectWithoutContext ("MacRx",
+      MakeCallback (&BleTestCaseLazyTransmitWindows::Received, this));
+
+  Simulator::Schedule (Seconds (2.0123), &BleTestCaseLazyTransmitWindows::Send,
+      this, dev0, dev1->GetAddress16());
+  Simulator::Schedule (Seconds (5.5), &BleTestCaseLazyTransmitWindows::Send,
+      this, dev1, dev0->GetAddress16());
+  Simulator::Schedule (Seconds (7.2571), &BleTestCaseLazyTransmitWindows::Send,
+      this, dev0, dev1->GetAddress16());
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  m_events = Simulator::GetEventCount ();
+  m_suspendedAtEnd = senderLinkManager->IsSuspended ()
+    && m_receiverLinkManager->IsSuspended ();
+  m_receiverLinkManager = 0;
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::BleLinkManager::LazyTransmitWindows",
+      BooleanValue (false));
+}
+
+void
+BleTestCaseLazyTransmitWindows::DoRun (void)
+{
+  Run (false);
+  std::vector<Time> rxTimes = m_rxTimes;
+  std::vector<uint8_t> rxChannels = m_rxChannels;
+  std::vector<uint16_t> rxEventCounters = m_rxEventCounters;
+  uint64_t events = m_events;
+  NS_TEST_ASSERT_MSG_EQ (rxTimes.size (), 2, "Wrong number of packets received");
+  NS_TEST_ASSERT_MSG_EQ (m_suspendedAtEnd, false,
+      "Windows are suspended by default");
+
+  Run (true);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), rxTimes.size (),
+      "Wrong number of packets received with lazy transmit windows");
+  for (uint32_t i = 0; i < std::min (rxTimes.size (), m_rxTimes.size ()); i++)
+  {
+    NS_TEST_ASSERT_MSG_EQ (m_rxTimes[i], rxTimes[i],
+        "Packet received at another time");
+    NS_TEST_ASSERT_MSG_EQ ((uint32_t) m_rxChannels[i], (uint32_t) rxChannels[i],
+        "Packet received on another channel");
+    NS_TEST_ASSERT_MSG_EQ (m_rxEventCounters[i], rxEventCounters[i],
+        "Packet received in another connection event");
+  }
+  NS_TEST_ASSERT_MSG_EQ (m_suspendedAtEnd, true,
+      "The idle link is not suspended");
+  NS_TEST_ASSERT_MSG_LT (m_events * 5, events,
+      "Idle windows were still scheduled");
+}
+
+
+
+// On a device with several links sharing anchor points, suspended windows
+// no longer take the radio: the other links skip fewer windows and can
+// send data that used to wait, data sent without suspension is unchanged
+class BleTestCaseLazyTransmitWindowsShared : public TestCase
+{
+public:
+  BleTestCaseLazyTransmitWindowsShared ();
+  virtual ~BleTestCaseLazyTransmitWindowsShared ();
+
+private:
+  virtual void DoRun (void);
+  void Run (bool lazy);
+  void Send (Ptr<BleNetDevice> from, Mac16Address to);
+  void Received (Ptr<const Packet> packet);
+
+  Ptr<BleNetDevice> m_central;
+  std::vector<Time> m_rxTimes;
+  std::vector<uint32_t> m_rxEvents; //!< channel * 65536 + event counter
+  uint32_t m_skipped;
+};
+
+BleTestCaseLazyTransmitWindowsShared::BleTestCaseLazyTransmitWindowsShared ()
+  : TestCase ("Ble test case suspends idle links of a device with several links"),
+    m_skipped (0)
+{
+}
+
+BleTestCaseLazyTransmitWindowsShared::~BleTestCaseLazyTransmitWindowsShared ()
+{
+}
+
+void
+BleTestCaseLazyTransmitWindowsShared::Send (Ptr<BleNetDevice> from,
+    Mac16Address to)
+{
+  from->Send (Create<Packet> (20), to, 0);
+}
+
+void
+BleTestCaseLazyTransmitWindowsShared::Received (Ptr<const Packet> packet)
+{
+  BleMacHeader bmh;
+  packet->PeekHeader (bmh);
+  Ptr<BleLinkManager> linkManager =
+    m_central->GetBBManager()->GetLinkManager (bmh.GetSrcAddr ());
+  m_rxTimes.push_back (Simulator::Now ());
+  m_rxEvents.push_back (linkManager->GetCurrentChannelIndex () * 65536
+      + linkManager->GetConnEventCounter ());
+}
+
+void
+BleTestCaseLazyTransmitWindowsShared::Run (bool lazy)
+{
+  Config::SetDefault ("ns3::BleLinkManager::LazyTransmitWindows",
+      BooleanValue (lazy));
+  m_rxTimes.clear ();
+  m_rxEvents.clear ();
+  uint32_t nPeers = 3;
+  // Connection intervals of 100 ms, 150 ms and 150 ms
+  std::vector<uint32_t> nbConnIntervals = {80, 120, 120};
+
+  BleHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = InstallLine (helper, nodes, nPeers + 1);
+  // All links of the central device start at the same anchor point,
+  // the central device listens as slave on each of them
+  m_central = DynamicCast<BleNetDevice>(devices.Get(0));
+  m_central->TraceConnectWithoutContext ("MacRx",
+      MakeCallback (&BleTestCaseLazyTransmitWindowsShared::Received, this));
+  std::vector<uint8_t> channels = {3, 8, 14, 21, 30};
+  for (uint32_t i = 1; i <= nPeers; i++)
+  {
+    Ptr<BleNetDevice> peer = DynamicCast<BleNetDevice>(devices.Get(i));
+    m_central->GetBBManager()->CreateLinkScheduled (peer->GetBBManager(),
+        BleLinkManager::Role::SLAVE_ROLE, true, 0, nbConnIntervals[i - 1]);
+    // The channel map is drawn randomly, use the same one in both runs
+    m_central->GetBBManager()->GetLinkManager (peer->GetAddress16())
+      ->SetUsedChannels (channels);
+    peer->GetBBManager()->GetLinkManager (m_central->GetAddress16())
+      ->SetUsedChannels (channels);
+    Simulator::Schedule (Seconds (0.5 * i + 0.0123),
+        &BleTestCaseLazyTransmitWindowsShared::Send, this, peer,
+        m_central->GetAddress16());
+  }
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  m_skipped = m_central->GetBBManager()->GetSkippedTransmitWindows ();
+  m_central = 0;
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::BleLinkManager::LazyTransmitWindows",
+      BooleanValue (false));
+}
+
+void
+BleTestCaseLazyTransmitWindowsShared::DoRun (void)
+{
+  Run (false);
+  std::vector<Time> rxTimes = m_rxTimes;
+  std::vector<uint32_t> rxEvents = m_rxEvents;
+  uint32_t skipped = m_skipped;
+  NS_TEST_ASSERT_MSG_GT (skipped, 0, "The links do not share anchor points");
+  NS_TEST_ASSERT_MSG_GT (rxTimes.size (), 0, "No packet received");
+
+  Run (true);
+  NS_TEST_ASSERT_MSG_EQ (m_skipped, 0,
+      "Suspended windows still took the radio");
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 3,
+      "Wrong number of packets received with lazy transmit windows");
+  // Packets that got through without suspension are unchanged
+  for (uint32_t i = 0; i < rxTimes.size (); i++)
+  {
+    bool found = false;
+    for (uint32_t j = 0; j < m_rxTimes.size (); j++)
+    {
+      found = found || (m_rxTimes[j] == rxTimes[i] && m_rxEvents[j] == rxEvents[i]);
+    }
+    NS_TEST_ASSERT_MSG_EQ (found, true,
+        "Packet received at another time or in another connection event");
+  }
+}
+
+
+
+// Transmit windows of links of one device that share an anchor point
+// are started by one event, the first one gets the radio
+class BleTestCaseTransmitWindowScheduler : public TestCase
+{
+public:
+  BleTestCaseTransmitWindowScheduler ();
+  virtual ~BleTestCaseTransmitWindowScheduler ();
+
+private:
+  virtual void DoRun (void);
+  void WindowSkipped (Ptr<const BleNetDevice> device);
+
+  uint32_t m_skippedTraced;
+};
+
+BleTestCaseTransmitWindowScheduler::BleTestCaseTransmitWindowScheduler ()
+  : TestCase ("Ble test case schedules the transmit windows of a device"),
+    m_skippedTraced (0)
+{
+}
+
+BleTestCaseTransmitWindowScheduler::~BleTestCaseTransmitWindowScheduler ()
+{
+}
+
+void
+BleTestCaseTransmitWindowScheduler::WindowSkipped (
+    Ptr<const BleNetDevice> device)
+{
+  m_skippedTraced++;
+}
+
+void
+BleTestCaseTransmitWindowScheduler::DoRun (void)
+{
+  uint32_t nPeers = 3;
+  // Connection intervals in units of 1.25 ms, 100 ms and 150 ms
+  std::vector<uint32_t> nbConnIntervals = {80, 120, 120};
+  uint32_t nbDuration = 1600; // 2 s
+
+  BleHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = InstallLine (helper, nodes, nPeers + 1);
+
+  // All links of the central device start at the same anchor point,
+  // the central device listens as slave on each of them
+  Ptr<BleNetDevice> central = DynamicCast<BleNetDevice>(devices.Get(0));
+  central->TraceConnectWithoutContext ("TXWindowSkipped",
+      MakeCallback (&BleTestCaseTransmitWindowScheduler::WindowSkipped, this));
+  for (uint32_t i = 1; i <= nPeers; i++)
+  {
+    Ptr<BleNetDevice> peer = DynamicCast<BleNetDevice>(devices.Get(i));
+    central->GetBBManager()->CreateLinkScheduled (peer->GetBBManager(),
+        BleLinkManager::Role::SLAVE_ROLE, true, 0, nbConnIntervals[i - 1]);
+  }
+
+  Simulator::Stop (Seconds (nbDuration * 1.25e-3));
+  Simulator::Run ();
+
+  // The first window is 1.25 ms after the start, at every anchor point
+  // only one of the links sharing it gets the radio
+  uint32_t expected = 0;
+  for (uint32_t t = 1; t < nbDuration; t++)
+  {
+    uint32_t sharing = 0;
+    for (uint32_t nbConnInterval : nbConnIntervals)
+    {
+      sharing += ((t - 1) % nbConnInterval == 0);
+    }
+    expected += (sharing > 1) ? sharing - 1 : 0;
+  }
+  uint32_t skipped = central->GetBBManager()->GetSkippedTransmitWindows ();
+  NS_TEST_ASSERT_MSG_EQ (skipped, expected,
+      "Skipped windows differ from the overlapping anchor points");
+  NS_TEST_ASSERT_MSG_EQ (m_skippedTraced, skipped,
+      "Skipped windows differ from the trace");
+  for (uint32_t i = 1; i <= nPeers; i++)
+  {
+    Ptr<BleNetDevice> peer = DynamicCast<BleNetDevice>(devices.Get(i));
+    NS_TEST_ASSERT_MSG_EQ (peer->GetBBManager()->GetSkippedTransmitWindows (), 0,
+        "A peer with a single link skipped a window");
+  }
+  Simulator::Destroy ();
+}
+
+
+// Keep-alive transmissions of an idle link reuse the empty PDUs of the
+// link manager, the packets are handed to the PHY without a copy
+class BleTestCaseEmptyPdu : public TestCase
+{
+public:
+  BleTestCaseEmptyPdu ();
+  virtual ~BleTestCaseEmptyPdu ();
+
+private:
+  virtual void DoRun (void);
+  void Transmitted (Mac16Address address, Ptr<const Packet> packet);
+
+  uint32_t m_transmitted;
+  bool m_headersValid;
+  std::set<const Packet *> m_packets;
+};
+
+BleTestCaseEmptyPdu::BleTestCaseEmptyPdu ()
+  : TestCase ("Ble test case shares the empty PDUs of a link"),
+    m_transmitted (0),
+    m_headersValid (true)
+{
+}
+
+BleTestCaseEmptyPdu::~BleTestCaseEmptyPdu ()
+{
+}
+
+void
+BleTestCaseEmptyPdu::Transmitted (Mac16Address address,
+    Ptr<const Packet> packet)
+{
+  BleMacHeader bmh;
+  packet->PeekHeader (bmh);
+  m_headersValid = m_headersValid && bmh.GetLLID () == 0b01
+    && bmh.GetMD () == 0 && bmh.GetSrcAddr () == address
+    && bmh.GetDestAddr () == Mac16Address ("FF:FF");
+  m_transmitted++;
+  m_packets.insert (PeekPointer (packet));
+}
+
+void
+BleTestCaseEmptyPdu::DoRun (void)
+{
+  BleHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = InstallLine (helper, nodes, 2);
+
+  Ptr<BleNetDevice> master = DynamicCast<BleNetDevice>(devices.Get(0));
+  Ptr<BleNetDevice> slave = DynamicCast<BleNetDevice>(devices.Get(1));
+  master->GetBBManager()->GetLinkController()->TraceConnectWithoutContext (
+      "MacTx", MakeCallback (&BleTestCaseEmptyPdu::Transmitted, this)
+      .Bind (master->GetAddress16 ()));
+  master->GetBBManager()->CreateLinkScheduled (slave->GetBBManager(),
+      BleLinkManager::Role::MASTER_ROLE, true, 0, 8); // 10 ms
+
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_transmitted, 90, "Too few keep-alive transmissions");
+  NS_TEST_ASSERT_MSG_EQ (m_headersValid, true, "Wrong empty PDU header");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_packets.size (), 4,
+      "Empty PDUs are not shared, one per SN and NESN");
+  Simulator::Destroy ();
+}
+
+
+// A packet sent by the net device is put in the queue of the link manager
+// of its destination right away
+class BleTestCaseDirectEnqueue : public TestCase
+{
+public:
+  BleTestCaseDirectEnqueue ();
+  virtual ~BleTestCaseDirectEnqueue ();
+
+private:
+  virtual void DoRun (void);
+  void Send (Ptr<BleNetDevice> from, Mac16Address to,
+      Ptr<BleLinkManager> linkManager);
+  void Received (Ptr<const Packet> packet);
+
+  uint32_t m_sent;
+  uint32_t m_enqueued;
+  uint32_t m_received;
+};
+
+BleTestCaseDirectEnqueue::BleTestCaseDirectEnqueue ()
+  : TestCase ("Ble test case enqueues sent packets at their link manager"),
+    m_sent (0),
+    m_enqueued (0),
+    m_received (0)
+{
+}
+
+BleTestCaseDirectEnqueue::~BleTestCaseDirectEnqueue ()
+{
+}
+
+void
+BleTestCaseDirectEnqueue::Send (Ptr<BleNetDevice> from, Mac16Address to,
+    Ptr<BleLinkManager> linkManager)
+{
+  uint32_t queued = linkManager->GetQueue ()->GetNPackets ();
+  m_sent += from->Send (Create<Packet> (20), to, 0);
+  m_enqueued += linkManager->GetQueue ()->GetNPackets () - queued;
+}
+
+void
+BleTestCaseDirectEnqueue::Received (Ptr<const Packet> packet)
+{
+  m_received++;
+}
+
+void
+BleTestCaseDirectEnqueue::DoRun (void)
+{
+  BleHelper helper;
+  NodeContainer nodes;
+  NetDeviceContainer devices = InstallLine (helper, nodes, 2);
+  // Connection interval of 100 ms
+  helper.CreateAllLinks (devices, true, 80);
+
+  Ptr<BleNetDevice> dev0 = DynamicCast<BleNetDevice>(devices.Get(0));
+  Ptr<BleNetDevice> dev1 = DynamicCast<BleNetDevice>(devices.Get(1));
+  Ptr<BleLinkManager> linkManager =
+    dev0->GetBBManager()->GetLinkManager (dev1->GetAddress16());
+  dev1->TraceConnectWithoutContext ("MacRx",
+      MakeCallback (&BleTestCaseDirectEnqueue::Received, this));
+
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    Simulator::Schedule (Seconds (0.5 + 0.15 * i),
+        &BleTestCaseDirectEnqueue::Send, this, dev0, dev1->GetAddress16(),
+        linkManager);
+  }
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_sent, 3, "Send failed");
+  NS_TEST_ASSERT_MSG_EQ (m_enqueued, 3,
+      "Packets were not enqueued at the link manager by Send");
+  NS_TEST_ASSERT_MSG_EQ (m_received, 3, "Wrong number of packets received");
+  Simulator::Destroy ();
+}
+
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -716,6 +1511,13 @@ BleTestSuite::BleTestSuite ()
   AddTestCase (new BleTestCase2, TestCase::QUICK);
   AddTestCase (new BleTestCase3, TestCase::QUICK);
   AddTestCase (new BleTestCase4, TestCase::QUICK);
+  AddTestCase (new BleTestCaseLinkLookup, TestCase::QUICK);
+  AddTestCase (new BleTestCaseLinksInRange, TestCase::QUICK);
+  AddTestCase (new BleTestCaseLazyTransmitWindows, TestCase::QUICK);
+  AddTestCase (new BleTestCaseLazyTransmitWindowsShared, TestCase::QUICK);
+  AddTestCase (new BleTestCaseTransmitWindowScheduler, TestCase::QUICK);
+  AddTestCase (new BleTestCaseEmptyPdu, TestCase::QUICK);
+  AddTestCase (new BleTestCaseDirectEnqueue, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite